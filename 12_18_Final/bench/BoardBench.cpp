@@ -0,0 +1,305 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <memory>
+#include "Board.hpp"
+#include "OpeningBook.hpp"
+#include "Placement.hpp"
+#include "FleetGenerator.hpp"
+#include "Player.hpp"
+#include "PowerUpPlanner.hpp"
+#include "Simulation.hpp"
+#include "Snapshot.hpp"
+#include "Strategy.hpp"
+#include "Terrain.hpp"
+
+using namespace std;
+
+// The old vector<vector<char>> board, kept here only to compare against
+typedef vector<vector<char>> CharGrid;
+
+static bool charAllShipsSunk(const CharGrid& grid) {
+    for (const auto& row : grid)
+    {
+        for (char cell : row)
+        {
+            if (cell == SHIP) return false;
+        }
+    }
+    return true;
+}
+
+static bool charIsValidPlacement(const CharGrid& grid, int x, int y, int length, char direction) {
+    if (direction == 'h')
+    {
+        if (y + length > GRID_SIZE) return false;
+        for (int j = 0; j < length; ++j) if (grid[x][y + j] != WATER) return false;
+    }
+    else if (direction == 'v')
+    {
+        if (x + length > GRID_SIZE) return false;
+        for (int j = 0; j < length; ++j) if (grid[x + j][y] != WATER) return false;
+    }
+    else
+    {
+        if (x + length > GRID_SIZE || y + length > GRID_SIZE) return false;
+        for (int j = 0; j < length; ++j) if (grid[x + j][y + j] != WATER) return false;
+    }
+    return true;
+}
+
+static int charReveal3x3(const CharGrid& grid, int x, int y) {
+    int hits = 0;
+    for (int i = -1; i <= 1; ++i)
+    {
+        for (int j = -1; j <= 1; ++j)
+        {
+            int newX = x + i, newY = y + j;
+            if (newX >= 0 && newX < GRID_SIZE && newY >= 0 && newY < GRID_SIZE && grid[newX][newY] == SHIP) hits++;
+        }
+    }
+    return hits;
+}
+
+static int maskReveal3x3(const Grid& board, int x, int y) {
+    return board.reveal(squareMask(x, y)).hits.count();
+}
+
+// Runs f 'iterations' times in ten rounds and prints the average cost per call of
+// the fastest round, so a burst of noise from elsewhere on the machine is left out
+template<typename F>
+static double timeIt(const string& label, int iterations, F f) {
+    const int ROUNDS = 10;
+    long long sink = 0;
+    double ns = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        int first = (int)((long long)iterations * round / ROUNDS), last = (int)((long long)iterations * (round + 1) / ROUNDS);
+        auto start = chrono::steady_clock::now();
+        for (int i = first; i < last; ++i) sink += f(i);
+        auto end = chrono::steady_clock::now();
+        double roundNs = chrono::duration<double, nano>(end - start).count() / (last - first);
+        if (round == 0 || roundNs < ns) ns = roundNs;
+    }
+    cout << "  " << label << ": " << ns << " ns/op (checksum " << sink << ")" << endl;
+    return ns;
+}
+
+int main() {
+    const int BOARDS = 256;
+    const int ITERATIONS = 5000000;
+    mt19937 rng(424);
+    const char symbols[] = {WATER, WATER, WATER, ISLAND, SHIP, HIT, MISS};
+
+    // Same random boards in both representations
+    vector<CharGrid> charBoards(BOARDS, CharGrid(GRID_SIZE, vector<char>(GRID_SIZE, WATER)));
+    vector<Grid> bitBoards(BOARDS);
+    for (int b = 0; b < BOARDS; ++b)
+    {
+        for (int x = 0; x < GRID_SIZE; ++x)
+        {
+            for (int y = 0; y < GRID_SIZE; ++y)
+            {
+                char symbol = symbols[rng() % 7];
+                if (b % 2 == 0 && symbol == SHIP) symbol = HIT; // Half the boards are fully sunk
+                charBoards[b][x][y] = symbol;
+                bitBoards[b].set(x, y, symbol);
+            }
+        }
+    }
+
+    // Random placement queries, shared by both versions
+    vector<int> qx(4096), qy(4096), qlen(4096);
+    vector<char> qdir(4096);
+    const char directions[] = {'h', 'v', 'd'};
+    for (int i = 0; i < 4096; ++i)
+    {
+        qx[i] = rng() % GRID_SIZE;
+        qy[i] = rng() % GRID_SIZE;
+        qlen[i] = 1 + rng() % 5;
+        qdir[i] = directions[rng() % 3];
+    }
+
+    cout << "allShipsSunk" << endl;
+    double a = timeIt("char grid", ITERATIONS, [&](int i) { return (int)charAllShipsSunk(charBoards[i % BOARDS]); });
+    double b = timeIt("bitboard ", ITERATIONS, [&](int i) { return (int)bitBoards[i % BOARDS].ships.none(); });
+    cout << "  speedup: " << a / b << "x" << endl;
+
+    // One random placement query per call, the char grid against fitsOn on the same boards.
+    // Placement loops take the occupied mask once and test many spots against it.
+    auto compareOneCheck = [&](const vector<CharGrid>& chars, const vector<Mask>& masks) {
+        double charNs = timeIt("char grid", ITERATIONS, [&](int i) {
+            int q = i % 4096;
+            return (int)charIsValidPlacement(chars[i % BOARDS], qx[q], qy[q], qlen[q], qdir[q]);
+        });
+        double maskNs = timeIt("bitboard ", ITERATIONS, [&](int i) {
+            int q = i % 4096;
+            return (int)fitsOn(masks[i % BOARDS], qx[q], qy[q], qlen[q], qdir[q]);
+        });
+        cout << "  speedup: " << charNs / maskNs << "x" << endl;
+    };
+
+    cout << "isValidPlacement" << endl;
+    vector<Mask> occupiedMasks(BOARDS);
+    for (int i = 0; i < BOARDS; ++i) occupiedMasks[i] = bitBoards[i].occupied();
+    compareOneCheck(charBoards, occupiedMasks);
+
+    // What placement really asks: every spot for the next ship on a board that only
+    // holds islands and the ships placed so far, so most checks run the full length
+    cout << "placement scan" << endl;
+    vector<CharGrid> placeChar(BOARDS, CharGrid(GRID_SIZE, vector<char>(GRID_SIZE, WATER)));
+    vector<Mask> placeMasks(BOARDS);
+    Rng placeRng(424);
+    for (int i = 0; i < BOARDS; ++i)
+    {
+        Mask islands = Terrain::scatterIslands(placeRng);
+        vector<const Placement*> ships;
+        FleetGenerator(islands, {2, 3, 4}).sample(placeRng, ships);
+        placeMasks[i] = islands;
+        for (const Placement* p : ships) placeMasks[i] |= p->cells;
+        placeMasks[i].forEach([&](int x, int y) { placeChar[i][x][y] = islands.test(x, y) ? ISLAND : SHIP; });
+    }
+    a = timeIt("char grid", ITERATIONS / 100, [&](int i) {
+        int legal = 0;
+        for (int cell = 0; cell < CELL_COUNT; ++cell)
+        {
+            for (char d : directions) legal += charIsValidPlacement(placeChar[i % BOARDS], cell / GRID_SIZE, cell % GRID_SIZE, 5, d);
+        }
+        return legal;
+    });
+    b = timeIt("fitsOn   ", ITERATIONS / 100, [&](int i) {
+        int legal = 0;
+        for (int cell = 0; cell < CELL_COUNT; ++cell)
+        {
+            for (char d : directions) legal += fitsOn(placeMasks[i % BOARDS], cell / GRID_SIZE, cell % GRID_SIZE, 5, d);
+        }
+        return legal;
+    });
+    cout << "  speedup: " << a / b << "x" << endl;
+    b = timeIt("table    ", ITERATIONS / 100, [&](int i) {
+        int legal = 0;
+        forEachLegalPlacement(placeMasks[i % BOARDS], 5, [&](const Placement&) { legal++; });
+        return legal;
+    });
+    cout << "  speedup: " << a / b << "x" << endl;
+
+    // Single random queries again, on those boards instead of the crowded ones above
+    cout << "one placement check on placement boards" << endl;
+    compareOneCheck(placeChar, placeMasks);
+
+    cout << "3x3 reveal" << endl;
+    a = timeIt("char grid", ITERATIONS, [&](int i) { int q = i % 4096; return charReveal3x3(charBoards[i % BOARDS], qx[q], qy[q]); });
+    b = timeIt("bitboard ", ITERATIONS, [&](int i) { int q = i % 4096; return maskReveal3x3(bitBoards[i % BOARDS], qx[q], qy[q]); });
+    cout << "  speedup: " << a / b << "x" << endl;
+
+    // Uniform complete fleets for Jenkins on the Open Seas
+    cout << "random fleet" << endl;
+    FleetGenerator generator(Mask(), {1, 2, 3, 4, 5});
+    Rng fleetRng(424);
+    vector<const Placement*> fleet;
+    double ns = timeIt("generator", 1000000, [&](int) { generator.sample(fleetRng, fleet); return fleet[0]->x; });
+    cout << "  " << 1e9 / ns << " layouts/sec" << endl;
+
+    // Forking a game halfway through: heap clones of both players against a flat snapshot
+    cout << "fork mid-game" << endl;
+    unique_ptr<Player> players[2] = {unique_ptr<Player>(createCaptain(1)), unique_ptr<Player>(createCaptain(3))};
+    GameEngine engine;
+    engine.begin(players[0].get(), players[1].get());
+    FleetGenerator generators[2];
+    placeFleetRandomly(engine, fleetRng, generators[0]);
+    placeFleetRandomly(engine, fleetRng, generators[1]);
+    RandomStrategy shooter(fleetRng);
+    while (engine.state.turn < 40 && engine.state.phase == Phase::Battle) engine.apply(shooter.chooseAction(engine));
+    a = timeIt("clone   ", 1000000, [&](int) {
+        unique_ptr<Player> first(players[0]->clone()), second(players[1]->clone());
+        return first->shipCellsLeft + second->shipCellsLeft;
+    });
+    GameSnapshot snapshot = engine.snapshot();
+    b = timeIt("snapshot", 1000000, [&](int i) { snapshot = engine.snapshot(); return snapshot.turn + i; });
+    cout << "  speedup: " << a / b << "x" << endl;
+    timeIt("restore ", 1000000, [&](int) { engine.restore(snapshot); return engine.state.turn; });
+    cout << "  snapshot size: " << sizeof(GameSnapshot) << " bytes" << endl;
+
+    // Parity bot: the decision alone, then whole headless games from a fresh battle
+    cout << "parity bot" << endl;
+    ParityStrategy parity[2] = {ParityStrategy(fleetRng), ParityStrategy(fleetRng)};
+    players[0].reset(createCaptain(1));
+    players[1].reset(createCaptain(3));
+    engine.begin(players[0].get(), players[1].get());
+    placeFleetRandomly(engine, fleetRng, generators[0]);
+    placeFleetRandomly(engine, fleetRng, generators[1]);
+    GameSnapshot battle = engine.snapshot();
+    ns = timeIt("decision", 10000000, [&](int) { return parity[0].chooseAction(engine).x; });
+    cout << "  " << 1e3 / ns << "M decisions/sec" << endl;
+    long long moves = 0;
+    ns = timeIt("game    ", 100000, [&](int) {
+        engine.restore(battle);
+        parity[0].reset();
+        parity[1].reset();
+        while (engine.state.phase == Phase::Battle)
+        {
+            Strategy& strategy = parity[engine.state.current];
+            Action action = strategy.chooseAction(engine);
+            strategy.observe(engine, action, engine.apply(action));
+            moves++;
+        }
+        return engine.state.winner;
+    });
+    cout << "  " << moves / (ns * 100000 / 1e9) / 1e6 << "M moves/sec with the engine" << endl;
+
+    // Power-up planner: 30 parity shots into a battle, then all 120 targets scored
+    cout << "power-up planner" << endl;
+    engine.restore(battle);
+    parity[0].reset();
+    DensityMap density;
+    density.reset(Mask(), players[1]->shipLengths);
+    for (int shot = 0; shot < 30 && engine.state.phase == Phase::Battle;)
+    {
+        if (engine.state.current != 0)
+        {
+            engine.apply(Action::endTurn());   // The other side passes
+            continue;
+        }
+        density.record(engine.apply(parity[0].chooseAction(engine)));
+        shot++;
+    }
+    Mask open = unexploredCells(*players[0]);
+    a = timeIt("per area ", 100000, [&](int) {
+        // Every 3x3 block and line summed cell by cell
+        double expected[CELL_COUNT], best = 0.0;
+        density.occupancy(open, expected);
+        for (int i = 0; i < CELL_COUNT + 2 * GRID_SIZE; ++i)
+        {
+            Mask area = i < CELL_COUNT ? SQUARES.around[i]
+                      : i < CELL_COUNT + GRID_SIZE ? Grid::row(i - CELL_COUNT) : Grid::column(i - CELL_COUNT - GRID_SIZE);
+            double total = 0.0;
+            area.forEach([&](int x, int y) { total += expected[x * GRID_SIZE + y]; });
+            if (total > best) best = total;
+        }
+        return (long long)(best * 100);
+    });
+    b = timeIt("summed   ", 100000, [&](int) {
+        PowerUpPlan plan = planPowerUps(density, open);
+        return (long long)(plan.center[plan.bestCenter()] * 100);
+    });
+    cout << "  speedup: " << a / b << "x" << endl;
+
+    // Opening book: first shot of a fresh game from the mapped file against the density map
+    cout << "opening book" << endl;
+    const string bookPath = "bench_book.bin";
+    OpeningBook::write(bookPath, {OpeningBook::build(Mask(), players[1]->shipLengths, BOOK_DEPTH, 20000, fleetRng)});
+    OpeningBook book;
+    book.open(bookPath);
+    engine.restore(battle);
+    density.reset(Mask(), players[1]->shipLengths);
+    Mask fresh = unexploredCells(*players[0]);
+    a = timeIt("density", 1000000, [&](int) { return density.bestCell(fresh, fleetRng); });
+    b = timeIt("book   ", 1000000, [&](int) { return book.nextShot(*players[0], players[1]->shipLengths); });
+    cout << "  speedup: " << a / b << "x" << endl;
+    book.close();
+    remove(bookPath.c_str());
+
+    return 0;
+}
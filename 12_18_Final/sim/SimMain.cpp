@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include "BatchEngine.hpp"
+#include "LayoutEnumerator.hpp"
+#include "OpeningBook.hpp"
+#include "Player.hpp"
+#include "Simulation.hpp"
+#include "Tournament.hpp"
+
+using namespace std;
+
+static void printUsage() {
+    cout << "Usage: battleship_sim [options]" << endl;
+    cout << "  --games N          games to play (default 100000)" << endl;
+    cout << "  --threads N        worker threads (default: all cores)" << endl;
+    cout << "  --seed N           base seed, game i uses a seed derived from it (default 424)" << endl;
+    cout << "  --p1 NAME          captain for player 1: jenkins, ironsides, steven (default jenkins)" << endl;
+    cout << "  --p2 NAME          captain for player 2 (default ironsides)" << endl;
+    cout << "  --map NAME         open or shattered (default open)" << endl;
+    cout << "  --strategy NAME    strategy for both players: random, playout, density, parity, mcts (default random)" << endl;
+    cout << "                     mcts:MS:THREADS sets the search time per move and its rollout threads," << endl;
+    cout << "                     mcts:Ni:THREADS N iterations per move instead. A time budget depends on the" << endl;
+    cout << "                     machine, so only the iteration form replays the same games from --seed" << endl;
+    cout << "  --s1 NAME          strategy for player 1 only" << endl;
+    cout << "  --s2 NAME          strategy for player 2 only" << endl;
+    cout << "  --tournament       play every captain pair x map x strategy pair, --games per cell" << endl;
+    cout << "  --strategies A,B   strategies entered in the tournament (default random)" << endl;
+    cout << "  --chunk N          games per scheduled tournament task (default 256)" << endl;
+    cout << "  --batch N          play random-vs-random games N at a time on the lockstep batch engine" << endl;
+    cout << "  --archive PATH     store each player's final own and guess boards, game g at index 4g to 4g + 3" << endl;
+    cout << "                     (open map only, an archive holds a single island layout)" << endl;
+    cout << "  --layouts          count every legal fleet layout of each captain on --map (shattered uses --seed)" << endl;
+    cout << "  --book PATH        computer strategies open from this opening book" << endl;
+    cout << "  --build-book PATH  add or refresh the opening lines against each captain on --map (shattered uses --seed)" << endl;
+    cout << "  --book-samples N   fleet layouts drawn per book shot (default 1000000)" << endl;
+}
+
+// Splits "a,b,c" into its names
+static vector<string> splitList(const string& list) {
+    vector<string> names;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t comma = list.find(',', start);
+        if (comma == string::npos) comma = list.size();
+        if (comma > start) names.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return names;
+}
+
+// Round-robin over the whole matrix, each cell reported as soon as it completes
+static int runTournament(const vector<string>& strategies, long long games, int threads, uint64_t seed, int chunk) {
+    Tournament tournament(strategies, games, seed, chunk);
+    if (!tournament.isValid())
+    {
+        cout << "Unknown strategy." << endl;
+        printUsage();
+        return 1;
+    }
+
+    cout << "Tournament: " << tournament.cellCount() << " cells x " << games << " games on " << threads << " threads" << endl;
+    auto start = chrono::steady_clock::now();
+    tournament.run(threads, cout);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double total = (double)tournament.cellCount() * games;
+    cout << total << " games in " << seconds << " s (" << total / seconds << " games/sec)" << endl;
+    return 0;
+}
+
+// Exact layout counts and per-cell ship frequencies for all three fleets
+static int runLayouts(bool shatteredSea, uint64_t seed, int threads) {
+    Rng rng(seed);
+    Mask islands = shatteredSea ? Terrain::scatterIslands(rng) : Mask();
+    cout << "Map: " << (shatteredSea ? "The Shattered Sea" : "The Open Seas") << endl;
+    for (int captain = 1; captain <= 3; ++captain)
+    {
+        unique_ptr<Player> player(createCaptain(captain));
+        auto start = chrono::steady_clock::now();
+        LayoutCount count = countLayouts(islands, player->shipLengths, threads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << endl << captainName(captain) << ": " << count.layouts << " layouts (" << count.orderedLayouts
+             << " placed ship by ship) in " << seconds << " s on " << threads << " threads" << endl;
+        cout << "Percent of layouts with a ship on each cell:" << endl;
+        for (int x = 0; x < GRID_SIZE; ++x)
+        {
+            for (int y = 0; y < GRID_SIZE; ++y)
+            {
+                if (islands.test(x, y)) cout << setw(6) << "#";
+                else cout << setw(6) << fixed << setprecision(1) << 100.0 * count.frequency(x, y);
+            }
+            cout << endl;
+        }
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+    return 0;
+}
+
+// Opening lines against all three fleets, merged into the book at 'path'
+static int runBuildBook(const string& path, bool shatteredSea, uint64_t seed, int samples, int threads) {
+    Rng rng(seed);
+    Mask islands = shatteredSea ? Terrain::scatterIslands(rng) : Mask();
+    cout << "Map: " << (shatteredSea ? "The Shattered Sea" : "The Open Seas") << endl;
+
+    // One captain per worker, each with its own stream
+    BookEntry lines[3];
+    Rng streams[3] = {rng.split(), rng.split(), rng.split()};
+    atomic<int> next(0);
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < min(threads, 3); ++t)
+    {
+        workers.emplace_back([&]() {
+            for (int c = next++; c < 3; c = next++)
+            {
+                unique_ptr<Player> player(createCaptain(c + 1));
+                lines[c] = OpeningBook::build(islands, player->shipLengths, BOOK_DEPTH, samples, streams[c]);
+            }
+        });
+    }
+    for (thread& worker : workers) worker.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Keep what the book already holds for other maps and fleets
+    vector<BookEntry> entries;
+    {
+        OpeningBook old;
+        if (old.open(path)) entries.assign(old.begin(), old.end());
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+        entries.push_back(lines[c]);
+        cout << "Against " << captainName(c + 1) << ":";
+        for (int i = 0; i < lines[c].shotCount; ++i)
+        {
+            cout << " (" << lines[c].shots[i] / GRID_SIZE << ", " << lines[c].shots[i] % GRID_SIZE << ")";
+        }
+        cout << endl;
+    }
+    if (!OpeningBook::write(path, entries))
+    {
+        cout << "Could not write " << path << endl;
+        return 1;
+    }
+    OpeningBook book;
+    book.open(path);
+    cout << "Built in " << seconds << " s on " << min(threads, 3) << " threads, " << path << " now holds "
+         << book.size() << " lines" << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    long long games = 100000;
+    int threads = (int)thread::hardware_concurrency();
+    uint64_t seed = 424;
+    MatchConfig config = {{1, 2}, false, {"random", "random"}, 1000};
+    bool tournament = false;
+    vector<string> tournamentStrategies = {"random"};
+    int chunk = 256;
+    int batch = 0;
+    bool layouts = false;
+    string bookPath, buildBookPath, archivePath;
+    int bookSamples = BOOK_SAMPLES;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "--tournament" || arg == "--layouts")
+        {
+            (arg == "--tournament" ? tournament : layouts) = true; // The only flags without a value
+            continue;
+        }
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--games") games = atoll(value.c_str());
+        else if (arg == "--threads") threads = atoi(value.c_str());
+        else if (arg == "--seed") seed = strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--p1") config.captains[0] = captainFromName(value);
+        else if (arg == "--p2") config.captains[1] = captainFromName(value);
+        else if (arg == "--map" && (value == "open" || value == "shattered")) config.shatteredSea = (value == "shattered");
+        else if (arg == "--strategy") config.strategies[0] = config.strategies[1] = value;
+        else if (arg == "--s1") config.strategies[0] = value;
+        else if (arg == "--s2") config.strategies[1] = value;
+        else if (arg == "--strategies") tournamentStrategies = splitList(value);
+        else if (arg == "--chunk") chunk = atoi(value.c_str());
+        else if (arg == "--batch") batch = atoi(value.c_str());
+        else if (arg == "--archive") archivePath = value;
+        else if (arg == "--book") bookPath = value;
+        else if (arg == "--build-book") buildBookPath = value;
+        else if (arg == "--book-samples") bookSamples = atoi(value.c_str());
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+        ++i; // Every option takes a value
+    }
+
+    if (threads < 1) threads = 1;
+    if (games < 1)
+    {
+        cout << "--games must be at least 1." << endl;
+        printUsage();
+        return 1;
+    }
+    if (layouts) return runLayouts(config.shatteredSea, seed, threads);
+    if (!buildBookPath.empty()) return runBuildBook(buildBookPath, config.shatteredSea, seed, max(bookSamples, 1), threads);
+    if (!bookPath.empty() && !OpeningBook::shared().open(bookPath))
+    {
+        cout << "Could not open the opening book " << bookPath << endl;
+        return 1;
+    }
+    if (tournament) return runTournament(tournamentStrategies, games, threads, seed, chunk);
+    if (config.captains[0] == 0 || config.captains[1] == 0 || !MatchRunner(config).isValid())
+    {
+        cout << "Unknown captain or strategy." << endl;
+        printUsage();
+        return 1;
+    }
+    if (batch > 0 && !BatchEngine(config, 1).isValid())
+    {
+        cout << "The batch engine only plays random against random." << endl;
+        return 1;
+    }
+
+    if (!archivePath.empty() && (config.shatteredSea || batch > 0))
+    {
+        cout << "--archive needs the open map (one archive holds one map) and no --batch." << endl;
+        return 1;
+    }
+    unique_ptr<BoardArchiveWriter> archive;
+    mutex archiveLock;
+    if (!archivePath.empty())
+    {
+        archive.reset(new BoardArchiveWriter(archivePath, *Terrain::openSeas()));
+        if (!archive->isOpen())
+        {
+            cout << "Could not write " << archivePath << endl;
+            return 1;
+        }
+    }
+
+    // Static split: thread t plays games t, t + threads, ... or, when archiving, runs of
+    // ARCHIVE_CHUNK games so each run goes to the file in one write at its game's index.
+    // Each worker has its own runner and stats, only the archive writes take a lock.
+    const long long ARCHIVE_CHUNK = 256;
+    vector<BatchStats> stats(threads, BatchStats());
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            if (batch > 0)
+            {
+                // Lockstep batches want contiguous game ranges. Game g gets the same seed, map and
+                // fleets as below, but its shots come from a shuffle instead of the random strategy's
+                // stream, so a batch game cannot be replayed move for move through MatchRunner
+                long long first = games * t / threads, last = games * (t + 1) / threads;
+                stats[t] = BatchEngine(config, batch).play(seed, first, last - first);
+                return;
+            }
+            MatchRunner runner(config);
+            BatchStats local = {};
+            if (!archive)
+            {
+                for (long long g = t; g < games; g += threads) local.add(runner.play(gameSeed(seed, (uint64_t)g)));
+                stats[t] = local;
+                return;
+            }
+
+            vector<PackedBoard> boards((size_t)(ARCHIVE_CHUNK * FINAL_BOARDS));
+            for (long long first = t * ARCHIVE_CHUNK; first < games; first += threads * ARCHIVE_CHUNK)
+            {
+                long long last = min(games, first + ARCHIVE_CHUNK);
+                for (long long g = first; g < last; ++g)
+                {
+                    local.add(runner.play(gameSeed(seed, (uint64_t)g), &boards[(size_t)((g - first) * FINAL_BOARDS)]));
+                }
+                lock_guard<mutex> hold(archiveLock);
+                archive->write((size_t)(first * FINAL_BOARDS), boards.data(), (size_t)((last - first) * FINAL_BOARDS));
+            }
+            stats[t] = local;
+        });
+    }
+    for (thread& worker : workers) worker.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    BatchStats total = {};
+    for (const BatchStats& s : stats) total.merge(s);
+
+    cout << total.games << " games on " << threads << " threads in " << seconds << " s ("
+         << total.games / seconds << " games/sec)" << endl;
+    cout << "Map: " << (config.shatteredSea ? "The Shattered Sea" : "The Open Seas") << endl;
+    for (int side = 0; side < 2; ++side)
+    {
+        cout << "Player " << side + 1 << " " << captainName(config.captains[side]) << " (" << config.strategies[side]
+             << "): " << 100.0 * total.wins[side] / total.games << "% wins" << endl;
+    }
+    cout << "Draws: " << 100.0 * total.draws / total.games << "%" << endl;
+    cout << "Average turns: " << (double)total.turns / total.games << endl;
+
+    if (archive)
+    {
+        if (!archive->finish())
+        {
+            cout << "Could not write " << archivePath << endl;
+            return 1;
+        }
+        cout << "Archived " << games * FINAL_BOARDS << " boards to " << archivePath << " ("
+             << PACKED_BOARD_BYTES << " bytes each)" << endl;
+    }
+    return 0;
+}
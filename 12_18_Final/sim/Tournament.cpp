@@ -0,0 +1,87 @@
+#include "Tournament.hpp"
+#include "WorkStealingPool.hpp"
+
+Tournament::Tournament(const vector<string>& strategies, long long gamesPerCell, uint64_t seed, int chunkSize)
+    : gamesPerCell(gamesPerCell), seed(seed), chunkSize(chunkSize < 1 ? 1 : chunkSize), cellsDone(0) {
+    for (int p1 = 1; p1 <= 3; ++p1)
+    {
+        for (int p2 = 1; p2 <= 3; ++p2)
+        {
+            for (int map = 0; map < 2; ++map)
+            {
+                for (const string& s1 : strategies)
+                {
+                    for (const string& s2 : strategies)
+                    {
+                        unique_ptr<TournamentCell> cell(new TournamentCell());
+                        cell->config = {{p1, p2}, map == 1, {s1, s2}, 1000};
+                        cell->stats = BatchStats();
+                        cells.push_back(move(cell));
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool Tournament::isValid() const {
+    for (const auto& cell : cells)
+    {
+        if (!MatchRunner(cell->config).isValid()) return false;
+    }
+    return !cells.empty();
+}
+
+void Tournament::run(int threads, ostream& out) {
+    WorkStealingPool pool(threads);
+    long long chunksPerCell = (gamesPerCell + chunkSize - 1) / chunkSize;
+    cellsDone = 0;
+
+    // Cells go in in order and each worker drains its own deque front first,
+    // so the early cells finish (and print) while the later ones are still queued
+    for (int c = 0; c < (int)cells.size(); ++c)
+    {
+        cells[c]->chunksLeft = (int)chunksPerCell;
+        for (long long first = 0; first < gamesPerCell; first += chunkSize)
+        {
+            long long last = first + chunkSize < gamesPerCell ? first + chunkSize : gamesPerCell;
+            pool.submit([this, c, first, last, &out]() { playChunk(c, first, last, out); });
+        }
+    }
+    pool.run();
+}
+
+void Tournament::playChunk(int cellIndex, long long first, long long last, ostream& out) {
+    TournamentCell& cell = *cells[cellIndex];
+    MatchRunner runner(cell.config);
+    uint64_t cellSeed = gameSeed(seed, (uint64_t)cellIndex);    // Each cell gets its own seed stream
+
+    BatchStats local = {};
+    for (long long g = first; g < last; ++g)
+    {
+        local.add(runner.play(gameSeed(cellSeed, (uint64_t)g)));
+    }
+
+    {
+        lock_guard<mutex> guard(cell.lock);
+        cell.stats.merge(local);
+    }
+    if (--cell.chunksLeft == 0) report(cellIndex, out);
+}
+
+void Tournament::report(int cellIndex, ostream& out) {
+    TournamentCell& cell = *cells[cellIndex];
+    const MatchConfig& config = cell.config;
+    const BatchStats& stats = cell.stats;   // Every chunk has merged, nobody writes it any more
+
+    lock_guard<mutex> guard(outputLock);
+    cellsDone++;
+    out << "[" << cellsDone << "/" << cells.size() << "] "
+        << captainName(config.captains[0]) << " (" << config.strategies[0] << ") vs "
+        << captainName(config.captains[1]) << " (" << config.strategies[1] << ") on "
+        << (config.shatteredSea ? "The Shattered Sea" : "The Open Seas") << ": "
+        << 100.0 * stats.wins[0] / stats.games << "% / "
+        << 100.0 * stats.wins[1] / stats.games << "% wins, "
+        << 100.0 * stats.draws / stats.games << "% draws, "
+        << (double)stats.turns / stats.games << " avg turns" << endl;
+}
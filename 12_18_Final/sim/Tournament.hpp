@@ -0,0 +1,44 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Simulation.hpp"
+
+using namespace std;
+
+// One matchup of the round-robin: captains, map and strategies for both sides
+struct TournamentCell {
+    MatchConfig config;
+    BatchStats stats;
+    atomic<int> chunksLeft;     // The chunk that takes this to zero reports the cell
+    mutex lock;                 // Guards stats while chunks merge in
+};
+
+// Every captain pair x map x strategy pair, split into fixed-size chunks of
+// games on a work-stealing pool. Cells are printed the moment they finish.
+class Tournament {
+public:
+    Tournament(const vector<string>& strategies, long long gamesPerCell, uint64_t seed, int chunkSize);
+    bool isValid() const;
+    size_t cellCount() const { return cells.size(); }
+    void run(int threads, ostream& out);
+
+private:
+    vector<unique_ptr<TournamentCell>> cells;
+    long long gamesPerCell;
+    uint64_t seed;
+    int chunkSize;
+    int cellsDone;
+    mutex outputLock;
+
+    void playChunk(int cellIndex, long long first, long long last, ostream& out);
+    void report(int cellIndex, ostream& out);
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "WorkStealingPool.hpp"
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int threads) : pending(0), nextQueue(0) {
+    for (int i = 0; i < threads; ++i)
+    {
+        queues.emplace_back(new WorkerQueue());
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    WorkerQueue& queue = *queues[nextQueue];
+    nextQueue = (nextQueue + 1) % (int)queues.size();
+    lock_guard<mutex> guard(queue.lock);
+    queue.tasks.push_back(move(task));
+    pending++;
+}
+
+void WorkStealingPool::run() {
+    vector<thread> workers;
+    for (int i = 0; i < (int)queues.size(); ++i)
+    {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+    for (thread& worker : workers) worker.join();
+}
+
+void WorkStealingPool::workerLoop(int self) {
+    Task task;
+    while (pending.load() > 0)
+    {
+        if (popLocal(self, task) || steal(self, task))
+        {
+            task();
+            pending--;
+        }
+        else
+        {
+            this_thread::yield(); // Everything left is already running elsewhere
+        }
+    }
+}
+
+bool WorkStealingPool::popLocal(int self, Task& task) {
+    // Own work in submission order, so early matrix cells finish first
+    WorkerQueue& queue = *queues[self];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.tasks.empty()) return false;
+    task = move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int self, Task& task) {
+    // Thieves take from the opposite end to stay out of the owner's way
+    int count = (int)queues.size();
+    for (int offset = 1; offset < count; ++offset)
+    {
+        WorkerQueue& victim = *queues[(self + offset) % count];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty())
+        {
+            task = move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,39 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads, each with its own task deque. A worker takes
+// tasks from the front of its own deque and, once that is empty, steals from
+// the back of another worker's deque, so long tasks never leave cores idle.
+class WorkStealingPool {
+public:
+    typedef function<void()> Task;
+
+    explicit WorkStealingPool(int threads);
+    void submit(Task task);     // Queue before run(), spread round-robin over the workers
+    void run();                 // Blocks until every task has finished
+
+private:
+    struct WorkerQueue {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    atomic<long long> pending;
+    int nextQueue;
+
+    void workerLoop(int self);
+    bool popLocal(int self, Task& task);
+    bool steal(int self, Task& task);
+};
+
+#endif
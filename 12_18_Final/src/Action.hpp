@@ -0,0 +1,35 @@
+#ifndef ACTION_HPP
+#define ACTION_HPP
+
+#include <cstdint>
+#include "Board.hpp"
+
+using namespace std;
+
+enum class ActionType { Place, Attack, PowerUp, EndTurn, Forfeit };
+
+// One move by the player whose turn it is
+struct Action {
+    ActionType type;
+    int x, y;       // Ship origin, attack cell or Jenkins center; Ironsides uses x for a row and y for a column
+    char mode;      // Direction h/v/d for Place, 'r'/'c' for the Ironsides power-up
+
+    static Action place(int x, int y, char direction) { return {ActionType::Place, x, y, direction}; }
+    static Action attack(int x, int y) { return {ActionType::Attack, x, y, ' '}; }
+    static Action powerUp(int x = 0, int y = 0, char mode = ' ') { return {ActionType::PowerUp, x, y, mode}; }
+    static Action endTurn() { return {ActionType::EndTurn, 0, 0, ' '}; }
+    static Action forfeit() { return {ActionType::Forfeit, 0, 0, ' '}; }   // Lose one attack, the turn ends with the last one
+};
+
+// What an action did, the state is untouched when 'accepted' is false
+struct Result {
+    bool accepted;
+    Mask hits;          // Opponent ship cells hit by this action
+    Mask misses;        // Open water revealed by this action
+    uint8_t sunkShips;  // Bit i is set if the opponent's ship i went down
+    int bonusAttacks;   // Extra attacks granted this turn (Steven's power-up)
+    bool turnOver;      // Control passed to the other player
+    bool gameOver;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "BatchEngine.hpp"
+#include <memory>
+#include "Player.hpp"
+#include "Terrain.hpp"
+
+BatchEngine::BatchEngine(const MatchConfig& config, int capacity)
+    : config(config), capacity(capacity < 1 ? 1 : capacity), live(0) {
+    for (int side = 0; side < 2; ++side)
+    {
+        // Same fleets selectCaptain hands out
+        unique_ptr<Player> captain(createCaptain(config.captains[side]));
+        if (captain) fleets[side] = captain->shipLengths;
+
+        for (int word = 0; word < WORDS; ++word) ships[side][word].resize(this->capacity);
+        shipCellsLeft[side].resize(this->capacity);
+        shots[side].resize((size_t)CELL_COUNT * this->capacity);
+    }
+}
+
+bool BatchEngine::isValid() const {
+    return !fleets[0].empty() && !fleets[1].empty()
+        && config.strategies[0] == "random" && config.strategies[1] == "random";
+}
+
+BatchStats BatchEngine::play(uint64_t baseSeed, long long first, long long count) {
+    BatchStats stats = {};
+    for (long long done = 0; done < count; done += capacity)
+    {
+        int batch = (int)(count - done < capacity ? count - done : capacity);
+        load(baseSeed, first + done, batch, stats);
+
+        // Turn t: side t % 2 fires its (t / 2)-th shot in every live game
+        for (int turn = 0; live > 0; ++turn)
+        {
+            int side = turn & 1;
+            if (turn >= config.maxTurns)
+            {
+                stats.draws += live;  // Same safety cap as MatchRunner
+                stats.games += live;
+                stats.turns += (long long)live * turn;
+                live = 0;
+                break;
+            }
+            fire(side, turn >> 1);
+            retire(side, turn >> 1, turn, stats);
+        }
+    }
+    return stats;
+}
+
+void BatchEngine::load(uint64_t baseSeed, long long first, int count, BatchStats& stats) {
+    live = 0;
+    for (int g = 0; g < count; ++g)
+    {
+        // A map too crowded for a fleet is a draw before the first shot, as in MatchRunner
+        if (setUp(live, gameSeed(baseSeed, (uint64_t)(first + g)))) live++;
+        else stats.add({-1, 0});
+    }
+}
+
+bool BatchEngine::setUp(int slot, uint64_t seed) {
+    // Same draws as MatchRunner::play up to the first shot: it splits off the two strategy
+    // streams before the map and both fleets, so skipping them gives this game the same layout
+    Rng rng(seed);
+    rng.split();
+    rng.split();
+    Mask islands = config.shatteredSea ? Terrain::scatterIslands(rng) : Mask();
+
+    for (int side = 0; side < 2; ++side)
+    {
+        // Fleet: uniform over every complete legal layout
+        Mask fleet = {};
+        fleetGenerators[side].reset(islands, fleets[side]);
+        if (!fleetGenerators[side].sample(rng, placements)) return false;
+        for (const Placement* p : placements) fleet |= p->cells;
+        for (int word = 0; word < WORDS; ++word) ships[side][word][slot] = fleet.w[word];
+        shipCellsLeft[side][slot] = (uint8_t)fleet.count();
+    }
+
+    for (int side = 0; side < 2; ++side)
+    {
+        // Firing at a uniformly random unexplored cell every turn is the same as
+        // walking a shuffled list of the open cells, so shuffle once up front
+        uint8_t order[CELL_COUNT];
+        int open = 0;
+        Mask::all().andNot(islands).forEach([&](int x, int y) { order[open++] = (uint8_t)(x * GRID_SIZE + y); });
+        for (int i = open - 1; i > 0; --i)
+        {
+            int j = (int)rng.below((uint32_t)(i + 1));
+            uint8_t swapped = order[i];
+            order[i] = order[j];
+            order[j] = swapped;
+        }
+        for (int i = 0; i < CELL_COUNT; ++i)
+        {
+            shots[side][(size_t)i * capacity + slot] = order[i < open ? i : open - 1];
+        }
+    }
+    return true;
+}
+
+void BatchEngine::fire(int side, int shotIndex) {
+    // One shot in every live game: test the target bit in the defender's ship
+    // words and take it off their count. A shuffled order never repeats a cell,
+    // so the masks stay read-only and the loop is branch-free and vectorizes.
+    const uint8_t* target = &shots[side][(size_t)shotIndex * capacity];
+    const uint64_t* low = ships[1 - side][0].data();
+    const uint64_t* high = ships[1 - side][1].data();
+    uint8_t* left = shipCellsLeft[1 - side].data();
+    for (int g = 0; g < live; ++g)
+    {
+        uint64_t cell = target[g];
+        uint64_t word = cell < 64 ? low[g] : high[g];
+        left[g] -= (uint8_t)((word >> (cell & 63)) & 1);
+    }
+}
+
+void BatchEngine::retire(int side, int shotIndex, int turn, BatchStats& stats) {
+    const uint8_t* left = shipCellsLeft[1 - side].data();
+    for (int g = 0; g < live;)
+    {
+        if (left[g] != 0)
+        {
+            ++g;
+            continue;
+        }
+        stats.add({side, turn});    // Winning shot, the turn itself is not counted as completed
+        moveGame(--live, g, shotIndex);
+    }
+}
+
+void BatchEngine::moveGame(int from, int to, int shotIndex) {
+    if (from == to) return;
+    for (int side = 0; side < 2; ++side)
+    {
+        for (int word = 0; word < WORDS; ++word) ships[side][word][to] = ships[side][word][from];
+        shipCellsLeft[side][to] = shipCellsLeft[side][from];
+        for (int i = shotIndex; i < CELL_COUNT; ++i)     // Shots already fired are never read again
+        {
+            shots[side][(size_t)i * capacity + to] = shots[side][(size_t)i * capacity + from];
+        }
+    }
+}
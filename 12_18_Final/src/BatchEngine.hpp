@@ -0,0 +1,48 @@
+#ifndef BATCHENGINE_HPP
+#define BATCHENGINE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Board.hpp"
+#include "FleetGenerator.hpp"
+#include "Simulation.hpp"
+
+using namespace std;
+
+// Plays many random-vs-random games in lockstep. Games are stored as
+// structure-of-arrays (one array per ship-mask word, per side), so a step is a
+// handful of flat loops over all live games that the compiler vectorizes.
+// Random fire never uses a power-up, so every game alternates one shot per
+// turn and all live games share the same turn number; finished games are
+// swapped out to the end so the loops only touch live ones.
+class BatchEngine {
+public:
+    BatchEngine(const MatchConfig& config, int capacity);
+    bool isValid() const;   // Captains known and both sides play "random"
+
+    // Plays games [first, first + count) of a run, game g seeded with gameSeed(baseSeed, g)
+    BatchStats play(uint64_t baseSeed, long long first, long long count);
+
+private:
+    static constexpr int WORDS = Mask::WORDS;
+    static_assert(WORDS == 2, "fire() picks between the two words of a 10x10 mask");
+
+    MatchConfig config;
+    vector<int> fleets[2];  // Ship lengths of each side's captain
+    int capacity;
+    int live;               // Games [0, live) are still running
+
+    vector<uint64_t> ships[2][WORDS];   // ships[side][word][game]
+    vector<uint8_t> shipCellsLeft[2];   // [side][game]
+    vector<uint8_t> shots[2];           // Shuffled firing order, shots[side][shotIndex * capacity + game]
+    vector<const Placement*> placements;    // Scratch for setUp
+    FleetGenerator fleetGenerators[2];  // Rebuilt per game only on the Shattered Sea
+
+    void load(uint64_t baseSeed, long long first, int count, BatchStats& stats);
+    bool setUp(int slot, uint64_t seed);    // False if a fleet did not fit the map
+    void fire(int side, int shotIndex);
+    void retire(int side, int shotIndex, int turn, BatchStats& stats);
+    void moveGame(int from, int to, int shotIndex);
+};
+
+#endif
@@ -0,0 +1,36 @@
+#include "Board.hpp"
+
+template<int Rows, int Cols>
+char Board<Rows, Cols>::at(int x, int y) const {
+    // Masks never overlap so the first match is the cell's symbol
+    if (ships.test(x, y)) return SHIP;
+    if (hits.test(x, y)) return HIT;
+    if (misses.test(x, y)) return MISS;
+    if (islands.test(x, y)) return ISLAND;
+    return WATER;
+}
+
+template<int Rows, int Cols>
+void Board<Rows, Cols>::set(int x, int y, char symbol) {
+    Mask c = Mask::cell(x, y);
+    ships = ships.andNot(c);        // Clear the cell from every layer
+    hits = hits.andNot(c);
+    misses = misses.andNot(c);
+    islands = islands.andNot(c);
+
+    if (symbol == SHIP) ships |= c;
+    else if (symbol == HIT) hits |= c;
+    else if (symbol == MISS) misses |= c;
+    else if (symbol == ISLAND) islands |= c;
+}
+
+template<int Rows, int Cols>
+int Board<Rows, Cols>::count(char symbol) const {
+    if (symbol == SHIP) return ships.count();
+    if (symbol == HIT) return hits.count();
+    if (symbol == MISS) return misses.count();
+    if (symbol == ISLAND) return islands.count();
+    return water().count();
+}
+
+template class Board<10, 10>;
@@ -0,0 +1,271 @@
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include <cstdint>
+#include "Constants.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Count the set bits of a 64-bit word
+inline int popcount64(uint64_t v) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(v);
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+// Index of the lowest set bit of a non-zero 64-bit word
+inline int lowestBit64(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// One bit per cell of a Rows x Cols board, bit (x * Cols + y) is cell (x, y).
+// Every loop runs over the constexpr WORDS so the compiler can unroll it.
+template<int Rows, int Cols>
+struct BitMask {
+    static constexpr int CELLS = Rows * Cols;
+    static constexpr int WORDS = (CELLS + 63) / 64;
+
+    uint64_t w[WORDS];
+
+    static constexpr BitMask cell(int x, int y) {
+        BitMask m = {};
+        m.setBit(x * Cols + y);
+        return m;
+    }
+
+    // 'length' consecutive bits starting at 'start' (1 <= length <= 64)
+    static constexpr BitMask run(int start, int length) {
+        BitMask m = {};
+        uint64_t bits = length == 64 ? ~0ULL : (1ULL << length) - 1;
+        int word = start >> 6, offset = start & 63;
+        m.w[word] = bits << offset;
+        if (offset + length > 64 && word + 1 < WORDS)
+        {
+            m.w[word + 1] = bits >> (64 - offset); // Spills into the next word
+        }
+        return m;
+    }
+
+    static constexpr BitMask all() {
+        // Every cell of the board, unused high bits stay clear
+        BitMask m = {};
+        for (int k = 0; k < WORDS; ++k)
+        {
+            int bitsInWord = CELLS - k * 64;
+            m.w[k] = bitsInWord >= 64 ? ~0ULL : (1ULL << bitsInWord) - 1;
+        }
+        return m;
+    }
+
+    constexpr void setBit(int index) { w[(unsigned)index >> 6] |= 1ULL << ((unsigned)index & 63); }
+
+    constexpr bool test(int x, int y) const {
+        unsigned index = (unsigned)(x * Cols + y);
+        return (w[index >> 6] >> (index & 63)) & 1ULL;
+    }
+
+    constexpr bool any() const {
+        uint64_t bits = 0;
+        for (int k = 0; k < WORDS; ++k) bits |= w[k];
+        return bits != 0;
+    }
+    constexpr bool none() const { return !any(); }
+    int count() const {
+        int total = 0;
+        for (int k = 0; k < WORDS; ++k) total += popcount64(w[k]);
+        return total;
+    }
+
+    constexpr BitMask operator&(const BitMask& o) const { BitMask m = {}; for (int k = 0; k < WORDS; ++k) m.w[k] = w[k] & o.w[k]; return m; }
+    constexpr BitMask operator|(const BitMask& o) const { BitMask m = {}; for (int k = 0; k < WORDS; ++k) m.w[k] = w[k] | o.w[k]; return m; }
+    constexpr BitMask operator^(const BitMask& o) const { BitMask m = {}; for (int k = 0; k < WORDS; ++k) m.w[k] = w[k] ^ o.w[k]; return m; }
+    constexpr BitMask andNot(const BitMask& o) const { BitMask m = {}; for (int k = 0; k < WORDS; ++k) m.w[k] = w[k] & ~o.w[k]; return m; }
+    constexpr BitMask& operator&=(const BitMask& o) { for (int k = 0; k < WORDS; ++k) w[k] &= o.w[k]; return *this; }
+    constexpr BitMask& operator|=(const BitMask& o) { for (int k = 0; k < WORDS; ++k) w[k] |= o.w[k]; return *this; }
+    // Bit i of the result is bit i + k of this mask (0 < k < 64), used to line up neighbouring cells
+    constexpr BitMask shiftDown(int k) const {
+        BitMask m = {};
+        for (int i = 0; i < WORDS; ++i)
+        {
+            m.w[i] = w[i] >> k;
+            if (i + 1 < WORDS) m.w[i] |= w[i + 1] << (64 - k);
+        }
+        return m;
+    }
+    constexpr bool operator==(const BitMask& o) const {
+        uint64_t diff = 0;
+        for (int k = 0; k < WORDS; ++k) diff |= w[k] ^ o.w[k];
+        return diff == 0;
+    }
+
+    // Bit index of the k-th set cell (k counts from 0 in row-major order), -1 if there are fewer
+    int nthSetBit(int k) const {
+        for (int word = 0; word < WORDS; ++word)
+        {
+            int inWord = popcount64(w[word]);
+            if (k < inWord)
+            {
+                uint64_t bits = w[word];
+                for (; k > 0; --k) bits &= bits - 1;   // Drop the lower set bits
+                return word * 64 + lowestBit64(bits);
+            }
+            k -= inWord;
+        }
+        return -1;
+    }
+
+    // Calls f(x, y) for every set cell in row-major order
+    template<typename F>
+    void forEach(F f) const {
+        for (int k = 0; k < WORDS; ++k)
+        {
+            uint64_t bits = w[k];
+            while (bits)
+            {
+                int index = k * 64 + lowestBit64(bits);
+                f(index / Cols, index % Cols);
+                bits &= bits - 1;   // Clear the lowest set bit
+            }
+        }
+    }
+};
+
+// A Rows x Cols board stored as one bitmask per cell symbol
+template<int Rows, int Cols>
+class Board {
+public:
+    typedef BitMask<Rows, Cols> Mask;
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+
+    Mask ships;
+    Mask hits;
+    Mask misses;
+    Mask islands;
+
+    Board() : ships(), hits(), misses(), islands() {}
+
+    char at(int x, int y) const;            // Symbol at (x, y), WATER if no mask has it
+    void set(int x, int y, char symbol);    // Overwrite the symbol at (x, y)
+    Mask occupied() const { return ships | hits | misses | islands; }
+    Mask water() const { return Mask::all().andNot(occupied()); }
+
+    static constexpr bool inBounds(int x, int y) { return x >= 0 && x < Rows && y >= 0 && y < Cols; }
+
+    // Cells covered by a ship of 'length' at (x,y) in direction h/v/d, empty if it leaves the board
+    static constexpr Mask line(int x, int y, int length, char direction);
+
+    // True if a ship of 'length' fits at (x,y) over open water only
+    bool canPlace(int x, int y, int length, char direction) const {
+        Mask shipCells = line(x, y, length, direction);
+        return shipCells.any() && (shipCells & occupied()).none();
+    }
+    void place(int x, int y, int length, char direction) { ships |= line(x, y, length, direction); }
+
+    int count(char symbol) const;           // Cells holding 'symbol'
+
+    // Area-reveal kernels: build the area as a mask, then split it into hits and misses
+    struct Reveal {
+        Mask hits;      // Ship cells inside the area
+        Mask misses;    // Open water inside the area
+    };
+    Reveal reveal(const Mask& area) const { return {area & ships, area & water()}; }
+
+    static constexpr Mask square(int x, int y, int radius);    // (2r+1)x(2r+1) block centered at (x,y), clipped
+    static constexpr Mask row(int x) { return ray(x, 0, 0, 1); }
+    static constexpr Mask column(int y) { return ray(0, y, 1, 0); }
+    static constexpr Mask diagonal(int x, int y);              // Down-right diagonal through (x,y)
+    static constexpr Mask antiDiagonal(int x, int y);          // Down-left diagonal through (x,y)
+
+private:
+    static constexpr Mask ray(int x, int y, int dx, int dy);   // From (x,y) stepping (dx,dy) to the edge
+};
+
+template<int Rows, int Cols>
+constexpr typename Board<Rows, Cols>::Mask Board<Rows, Cols>::line(int x, int y, int length, char direction) {
+    int dx = 0, dy = 0;
+    if (direction == 'h') { dx = 0; dy = 1; }        // Horizontal, to the right
+    else if (direction == 'v') { dx = 1; dy = 0; }   // Vertical, downwards
+    else if (direction == 'd') { dx = 1; dy = 1; }   // Diagonal, down and right
+    else return Mask();                              // Invalid direction character
+
+    int endX = x + dx * (length - 1);
+    int endY = y + dy * (length - 1);
+    if (length <= 0 || x < 0 || y < 0 || endX >= Rows || endY >= Cols)
+    {
+        return Mask(); // Goes off the board
+    }
+
+    int index = x * Cols + y;
+    if (direction == 'h' && length <= 64)
+    {
+        return Mask::run(index, length); // A row segment is one run of bits
+    }
+
+    Mask m = {};
+    int step = dx * Cols + dy;   // Distance between neighbouring ship cells in bit positions
+    for (int j = 0; j < length; ++j, index += step)
+    {
+        m.setBit(index);
+    }
+    return m;
+}
+
+template<int Rows, int Cols>
+constexpr typename Board<Rows, Cols>::Mask Board<Rows, Cols>::ray(int x, int y, int dx, int dy) {
+    Mask m = {};
+    for (; inBounds(x, y); x += dx, y += dy)
+    {
+        m.setBit(x * Cols + y);
+    }
+    return m;
+}
+
+template<int Rows, int Cols>
+constexpr typename Board<Rows, Cols>::Mask Board<Rows, Cols>::square(int x, int y, int radius) {
+    Mask m = {};
+    int top = x - radius < 0 ? 0 : x - radius;
+    int bottom = x + radius >= Rows ? Rows - 1 : x + radius;
+    int left = y - radius < 0 ? 0 : y - radius;
+    int right = y + radius >= Cols ? Cols - 1 : y + radius;
+    if (top > bottom || left > right) return m; // Entirely off the board
+
+    for (int i = top; i <= bottom; ++i)
+    {
+        m |= line(i, left, right - left + 1, 'h'); // One clipped row of the block at a time
+    }
+    return m;
+}
+
+template<int Rows, int Cols>
+constexpr typename Board<Rows, Cols>::Mask Board<Rows, Cols>::diagonal(int x, int y) {
+    int back = x < y ? x : y;   // Walk back to the top or left edge first
+    return ray(x - back, y - back, 1, 1);
+}
+
+template<int Rows, int Cols>
+constexpr typename Board<Rows, Cols>::Mask Board<Rows, Cols>::antiDiagonal(int x, int y) {
+    int back = x < Cols - 1 - y ? x : Cols - 1 - y;  // Walk back to the top or right edge first
+    return ray(x - back, y + back, 1, -1);
+}
+
+// The board the game uses, compiled once in Board.cpp
+extern template class Board<10, 10>;
+
+typedef Board<GRID_SIZE, GRID_SIZE> Grid;
+typedef Grid::Mask Mask;
+const int CELL_COUNT = Grid::Mask::CELLS;
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+// Where the console game gets its time from and how it waits between turns.
+// Blitz limits and screen handoffs only go through this, never steady_clock.
+class Clock {
+public:
+    typedef chrono::steady_clock::time_point TimePoint;
+    typedef chrono::steady_clock::duration Duration;
+
+    virtual ~Clock() = default;
+    virtual TimePoint now() const = 0;
+    virtual void pause(Duration delay) = 0;     // Handoff and end-of-game delays
+    virtual void inputRead() {}                 // Called after every line of input
+
+    long long secondsSince(TimePoint start) const {
+        return chrono::duration_cast<chrono::seconds>(now() - start).count();
+    }
+};
+
+// Wall time for hotseat play at the terminal
+class RealClock : public Clock {
+public:
+    TimePoint now() const override { return chrono::steady_clock::now(); }
+    void pause(Duration delay) override { this_thread::sleep_for(delay); }
+};
+
+// Simulated time for scripted games and tests. Pauses cost no wall time and
+// every input costs a fixed step, so blitz timeouts land on the same input every run.
+class VirtualClock : public Clock {
+public:
+    explicit VirtualClock(Duration perInput = chrono::seconds(1)) : current(), perInput(perInput) {}
+
+    TimePoint now() const override { return current; }
+    void pause(Duration delay) override { current += delay; }
+    void inputRead() override { current += perInput; }
+    void advance(Duration delay) { current += delay; }
+
+private:
+    TimePoint current;
+    Duration perInput;
+};
+
+#endif
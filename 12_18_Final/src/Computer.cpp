@@ -0,0 +1,71 @@
+#include "Computer.hpp"
+#include "Game.hpp"
+#include "OpeningBook.hpp"
+#include "Strategy.hpp"
+
+template<typename Captain>
+Computer<Captain>::Computer() : Captain(), ready(false) {
+    this->name += " (computer)";
+}
+
+template<typename Captain>
+void Computer<Captain>::placeShips(Game& game) {
+    // Placed out of sight, the grid is never printed. The generator has already made
+    // its full run of draws when it fails, so the fleet stays unplaced and Game::start
+    // ends the game instead of waiting on a placement that will never come.
+    if (this->autoPlaceShips(game)) 
+    {
+        cout << this->name << " has placed its ships." << endl;
+        return;
+    }
+    cout << this->name << " found no room for its fleet on this map." << endl;
+    event("could not place its fleet", this->name);
+}
+
+template<typename Captain>
+void Computer<Captain>::playTurn(Game& game) {
+    Player& opponent = game.engine.defender();
+    if (!ready) 
+    {
+        density.reset(this->terrain->islands, opponent.shipLengths);
+        ready = true;
+    }
+
+    int cell = OpeningBook::shared().nextShot(*this, opponent.shipLengths);
+    if (cell < 0) cell = density.bestCell(unexploredCells(*this), game.rng);
+    if (cell < 0) 
+    {
+        game.engine.apply(Action::endTurn()); // Nothing left to shoot at
+        return;
+    }
+
+    int x = cell / GRID_SIZE, y = cell % GRID_SIZE;
+    Result result = game.engine.apply(Action::attack(x, y));
+    density.record(result);
+
+    cout << this->name << " fires at (" << x << ", " << y << ")";
+    if (result.hits.any()) 
+    {
+        cout << " and hits!" << endl;
+        event("successful hit", this->name, x, y);
+    } 
+    
+    else 
+    {
+        cout << " and misses." << endl;
+        event("unsuccessful hit", this->name, x, y);
+    }
+
+    for (const Ship& ship : opponent.ships) 
+    {
+        if (result.sunkShips & (1 << ship.id)) 
+        {
+            cout << this->name << " sunk your ship of length " << ship.length << "!" << endl;
+            event("sunk a ship", this->name, ship.x, ship.y, ship.direction);
+        }
+    }
+}
+
+template class Computer<Jenkins>;
+template class Computer<Ironsides>;
+template class Computer<Steven>;
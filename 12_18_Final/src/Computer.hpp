@@ -0,0 +1,32 @@
+#ifndef COMPUTER_HPP
+#define COMPUTER_HPP
+
+#include "Player.hpp"
+#include "DensityMap.hpp"
+
+using namespace std;
+
+// Any captain played by the computer. The fleet goes down at random and every
+// attack goes to the cell most of the opponent's possible layouts cover,
+// tracked shot by shot in a DensityMap, or follows the opening book until the
+// first hit. It keeps the captain's power-up rules but never uses it.
+template<typename Captain>
+class Computer : public Captain {
+public:
+    Computer();
+    Player* clone() const override { return new Computer(*this); }
+    bool isComputer() const override { return true; }
+    void placeShips(Game& game) override;
+    void playTurn(Game& game) override;
+
+private:
+    DensityMap density;
+    bool ready;     // Density set up on the first turn, once the map and the opponent are fixed
+};
+
+// Built for these three only, see Computer.cpp
+extern template class Computer<Jenkins>;
+extern template class Computer<Ironsides>;
+extern template class Computer<Steven>;
+
+#endif
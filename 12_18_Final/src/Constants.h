@@ -1,7 +1,7 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
-const int GRID_SIZE = 10;
+constexpr int GRID_SIZE = 10;
 const char WATER = '~';
 const char ISLAND = 'I';
 const char SHIP = 'S';
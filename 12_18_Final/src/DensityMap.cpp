@@ -0,0 +1,173 @@
+#include "DensityMap.hpp"
+#include <cstring>
+
+DensityMap::DensityMap() : lengthKinds(0), openHits() {
+    reset(Mask(), {});
+}
+
+void DensityMap::reset(const Mask& blocked, const vector<int>& fleet) {
+    shipLengths = fleet;
+    lengthKinds = 0;
+    memset(floating, 0, sizeof(floating));
+    memset(live, 0, sizeof(live));
+    memset(alive, 0, sizeof(alive));
+    memset(hitsCovered, 0, sizeof(hitsCovered));
+    memset(hunt, 0, sizeof(hunt));
+    memset(target, 0, sizeof(target));
+    openHits = Mask();
+
+    for (int length : shipLengths)
+    {
+        if (length < 1 || length > MAX_SHIP_LENGTH) continue;  // Not in the placement table
+        if (floating[length]++ == 0) lengths[lengthKinds++] = length;
+    }
+
+    // Every placement that clears the islands starts out possible
+    for (int k = 0; k < lengthKinds; ++k)
+    {
+        int length = lengths[k];
+        int directions = length == 1 ? 1 : DIRECTION_COUNT;
+        for (int spot = 0; spot < directions * CELL_COUNT; ++spot)
+        {
+            const Mask& cells = spotCells(length, spot);
+            if (cells.none() || (cells & blocked).any()) continue;
+            alive[length][spot] = true;
+            live[length]++;
+            cells.forEach([&](int x, int y) { hunt[length][x * GRID_SIZE + y]++; });
+        }
+    }
+}
+
+void DensityMap::record(const Result& result) {
+    if (!result.accepted) return;
+
+    // Water rules out every placement through it, islands were taken out at reset
+    result.misses.forEach([&](int x, int y) {
+        int cell = x * GRID_SIZE + y;
+        for (int k = 0; k < lengthKinds; ++k)
+        {
+            forEachLiveSpot(lengths[k], cell, [&](int spot) { kill(lengths[k], spot); });
+        }
+    });
+
+    result.hits.forEach([&](int x, int y) { addHit(x * GRID_SIZE + y); });
+
+    for (int id = 0; id < (int)shipLengths.size(); ++id)
+    {
+        if (result.sunkShips & (1 << id)) sink(shipLengths[id], result.hits);
+    }
+}
+
+int DensityMap::bestCell(const Mask& candidates, Rng& rng) const {
+    // Target tally while a hit is unresolved, falling back to the hunt tally
+    // once every placement through the open hits has been shot at
+    for (int pass = targeting() ? 0 : 1; pass < 2; ++pass)
+    {
+        const int32_t (*tally)[CELL_COUNT] = pass == 0 ? target : hunt;
+        uint64_t best = 0;
+        int bestCell = -1, ties = 0;
+        candidates.forEach([&](int x, int y) {
+            int cell = x * GRID_SIZE + y;
+            uint64_t s = score(tally, cell);
+            if (s < best || s == 0) return;
+            if (s > best)
+            {
+                best = s;
+                ties = 0;
+            }
+            if (rng.below((uint32_t)++ties) == 0) bestCell = cell;  // Uniform among the tied cells
+        });
+        if (bestCell >= 0) return bestCell;
+    }
+
+    // Nothing fits anywhere (the hits were misread), any candidate will do
+    int count = candidates.count();
+    return count ? candidates.nthSetBit((int)rng.below((uint32_t)count)) : -1;
+}
+
+void DensityMap::occupancy(const Mask& open, double* expected) const {
+    // Chance that one ship of each length sits on one given placement. A placement
+    // through unresolved hits weighs 1 + HIT_WEIGHT per hit, the target tally holds
+    // exactly that extra weight cell by cell.
+    const double HIT_WEIGHT = 20.0;
+    double perPlacement[MAX_SHIP_LENGTH];
+    for (int k = 0; k < lengthKinds; ++k)
+    {
+        int length = lengths[k];
+        double covered = 0.0;   // Sum of hitsCovered over live placements, every one is counted once per cell
+        for (int cell = 0; cell < CELL_COUNT; ++cell) covered += target[length][cell];
+        double total = live[length] + HIT_WEIGHT * covered / length;
+        perPlacement[k] = total > 0 ? floating[length] / total : 0.0;
+    }
+    for (int cell = 0; cell < CELL_COUNT; ++cell) expected[cell] = 0.0;
+    open.forEach([&](int x, int y) {
+        int cell = x * GRID_SIZE + y;
+        double total = 0.0;
+        for (int k = 0; k < lengthKinds; ++k)
+        {
+            total += perPlacement[k] * (hunt[lengths[k]][cell] + HIT_WEIGHT * target[lengths[k]][cell]);
+        }
+        expected[cell] = total < 1.0 ? total : 1.0;
+    });
+}
+
+uint64_t DensityMap::score(const int32_t tally[][CELL_COUNT], int cell) const {
+    // Each length counts once per ship of that length still afloat
+    uint64_t total = 0;
+    for (int k = 0; k < lengthKinds; ++k)
+    {
+        total += (uint64_t)floating[lengths[k]] * (uint64_t)tally[lengths[k]][cell];
+    }
+    return total;
+}
+
+void DensityMap::kill(int length, int spot) {
+    alive[length][spot] = false;
+    live[length]--;
+    int weight = hitsCovered[length][spot];
+    spotCells(length, spot).forEach([&](int x, int y) {
+        int cell = x * GRID_SIZE + y;
+        hunt[length][cell]--;
+        target[length][cell] -= weight;
+    });
+}
+
+void DensityMap::addHit(int cell) {
+    openHits.setBit(cell);
+    for (int k = 0; k < lengthKinds; ++k)
+    {
+        int length = lengths[k];
+        forEachLiveSpot(length, cell, [&](int spot) {
+            hitsCovered[length][spot]++;
+            spotCells(length, spot).forEach([&](int x, int y) { target[length][x * GRID_SIZE + y]++; });
+        });
+    }
+}
+
+void DensityMap::sink(int length, const Mask& lastHits) {
+    if (length < 1 || length > MAX_SHIP_LENGTH) return;
+    if (floating[length] > 0) floating[length]--;
+
+    // The sunk ship lies on open hits and takes one of the cells just hit. Only
+    // when exactly one placement fits is it known where the ship was.
+    int found = -1, matches = 0;
+    lastHits.forEach([&](int x, int y) {
+        forEachLiveSpot(length, x * GRID_SIZE + y, [&](int spot) {
+            if (spot == found || spotCells(length, spot).andNot(openHits).any()) return;
+            matches = found < 0 ? 1 : 2;   // A second distinct fit makes it ambiguous
+            if (found < 0) found = spot;
+        });
+    });
+    if (matches == 1) close(spotCells(length, found));
+}
+
+void DensityMap::close(const Mask& cells) {
+    openHits = openHits.andNot(cells);
+    cells.forEach([&](int x, int y) {
+        int cell = x * GRID_SIZE + y;
+        for (int k = 0; k < lengthKinds; ++k)
+        {
+            forEachLiveSpot(lengths[k], cell, [&](int spot) { kill(lengths[k], spot); });
+        }
+    });
+}
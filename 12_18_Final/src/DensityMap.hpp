@@ -0,0 +1,78 @@
+#ifndef DENSITYMAP_HPP
+#define DENSITYMAP_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Action.hpp"
+#include "Placement.hpp"
+#include "Rng.hpp"
+
+using namespace std;
+
+// For every cell, how many placements of the opponent's floating ships are still
+// possible through it, given what our own shots have shown. Each placement is
+// tracked once and only the ones through a newly revealed cell are touched, so
+// folding in a shot costs a few dozen adds instead of a rescan of the board.
+//
+// Two tallies are kept per ship length: 'hunt' counts every surviving placement,
+// 'target' weighs each one by the unresolved hits it covers. While there is an
+// unresolved hit the target tally picks the shot, otherwise the hunt tally does.
+class DensityMap {
+public:
+    DensityMap();
+
+    void reset(const Mask& blocked, const vector<int>& shipLengths);   // New game against this fleet, 'blocked' is the islands
+    void record(const Result& result);      // Fold in the hits, misses and sinkings of one of our actions
+
+    int bestCell(const Mask& candidates, Rng& rng) const;  // Top scoring candidate cell index, ties at random, -1 if none
+    uint64_t huntScore(int cell) const { return score(hunt, cell); }
+    uint64_t targetScore(int cell) const { return score(target, cell); }
+    bool targeting() const { return openHits.any(); }      // A hit that no sunk ship accounts for yet
+
+    // Expected number of ships on each 'open' cell, 0 elsewhere: each ship afloat
+    // covers a cell with the share of its live placements through it, where a
+    // placement over unresolved hits counts many times over. Capped at 1.
+    void occupancy(const Mask& open, double* expected) const;
+
+private:
+    static const int SPOTS = DIRECTION_COUNT * CELL_COUNT;  // Placement index: direction * CELL_COUNT + start cell
+
+    vector<int> shipLengths;
+    int lengths[MAX_SHIP_LENGTH];           // Distinct lengths in the fleet
+    int lengthKinds;
+    int floating[MAX_SHIP_LENGTH + 1];      // Ships of each length not sunk yet
+    int live[MAX_SHIP_LENGTH + 1];          // Placements of each length still possible
+    bool alive[MAX_SHIP_LENGTH + 1][SPOTS];
+    uint8_t hitsCovered[MAX_SHIP_LENGTH + 1][SPOTS];
+    int32_t hunt[MAX_SHIP_LENGTH + 1][CELL_COUNT];
+    int32_t target[MAX_SHIP_LENGTH + 1][CELL_COUNT];
+    Mask openHits;
+
+    uint64_t score(const int32_t tally[][CELL_COUNT], int cell) const;
+    void kill(int length, int spot);        // Placement ruled out, take it off both tallies
+    void addHit(int cell);
+    void sink(int length, const Mask& lastHits);
+    void close(const Mask& cells);          // Cells of a sunk ship, no other ship can use them
+
+    // Calls f(spot) for every live placement of 'length' through 'cell'
+    template<typename F>
+    void forEachLiveSpot(int length, int cell, F f) const {
+        int directions = length == 1 ? 1 : DIRECTION_COUNT;    // A single cell is the same every way
+        for (int d = 0; d < directions; ++d)
+        {
+            for (int j = 0; j < length; ++j)
+            {
+                int start = cell - j * DIRECTION_STEPS[d];
+                if (start < 0) break;
+                int spot = d * CELL_COUNT + start;
+                if (alive[length][spot] && PLACEMENTS.masks[length][d][start].test(cell / GRID_SIZE, cell % GRID_SIZE)) f(spot);
+            }
+        }
+    }
+
+    static const Mask& spotCells(int length, int spot) {
+        return PLACEMENTS.masks[length][spot / CELL_COUNT][spot % CELL_COUNT];
+    }
+};
+
+#endif
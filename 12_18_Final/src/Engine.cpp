@@ -0,0 +1,142 @@
+#include "Engine.hpp"
+#include "Player.hpp"
+#include "Snapshot.hpp"
+
+GameEngine::GameEngine() : state() {
+    state.winner = -1;
+}
+
+void GameEngine::begin(Player* first, Player* second) {
+    state = GameState();
+    state.players[0] = first;
+    state.players[1] = second;
+    state.phase = Phase::Placement;
+    state.winner = -1;
+}
+
+GameSnapshot GameEngine::snapshot() const {
+    GameSnapshot snapshot;
+    snapshot.islands = state.players[0]->terrain->islands;
+    for (int side = 0; side < 2; ++side) state.players[side]->save(snapshot.players[side]);
+    snapshot.current = state.current;
+    snapshot.phase = state.phase;
+    snapshot.turn = state.turn;
+    snapshot.bonusAttacks = state.bonusAttacks;
+    snapshot.winner = state.winner;
+    return snapshot;
+}
+
+void GameEngine::restore(const GameSnapshot& snapshot) {
+    // Only a snapshot from another map needs a new terrain, both players share it
+    if (!(state.players[0]->terrain->islands == snapshot.islands))
+    {
+        TerrainPtr terrain = make_shared<const Terrain>(snapshot.islands);
+        state.players[0]->terrain = state.players[1]->terrain = terrain;
+    }
+    for (int side = 0; side < 2; ++side) state.players[side]->restore(snapshot.players[side]);
+    state.current = snapshot.current;
+    state.phase = snapshot.phase;
+    state.turn = snapshot.turn;
+    state.bonusAttacks = snapshot.bonusAttacks;
+    state.winner = snapshot.winner;
+}
+
+Player& GameEngine::attacker() const {
+    return *state.players[state.current];
+}
+
+Player& GameEngine::defender() const {
+    return *state.players[1 - state.current];
+}
+
+Result GameEngine::apply(const Action& action) {
+    Result result = {};
+    if (state.phase == Phase::Placement)
+    {
+        if (action.type == ActionType::Place) place(action, result);
+        return result; // Nothing else is allowed before both fleets are out
+    }
+
+    if (state.phase == Phase::Finished) return result;
+
+    if (action.type == ActionType::Attack) attack(action, result);
+    else if (action.type == ActionType::PowerUp) powerUp(action, result);
+    else if (action.type == ActionType::EndTurn)
+    {
+        result.accepted = true; // Passing is always allowed (e.g. blitz timeout)
+        finishTurn(result);
+    }
+    else if (action.type == ActionType::Forfeit)
+    {
+        // A wasted shot of Steven's triple shot only costs that shot
+        result.accepted = true;
+        if (state.bonusAttacks > 0 && --state.bonusAttacks > 0) return result;
+        finishTurn(result);
+    }
+    return result;
+}
+
+void GameEngine::place(const Action& action, Result& result) {
+    Player& player = attacker();
+    if (player.fleetPlaced()) return;
+
+    // Ships go down in fleet order
+    int length = player.shipLengths[player.ships.size()];
+    if (!player.canPlaceShip(action.x, action.y, length, action.mode)) return;
+    player.addShip(action.x, action.y, length, action.mode);
+    result.accepted = true;
+
+    if (player.fleetPlaced())
+    {
+        if (defender().fleetPlaced())
+        {
+            state.phase = Phase::Battle;   // Both fleets are out, first player opens fire
+            state.current = 0;
+        }
+        else
+        {
+            state.current = 1 - state.current;
+        }
+        result.turnOver = true;
+    }
+}
+
+void GameEngine::attack(const Action& action, Result& result) {
+    if (!attacker().fire(defender(), action.x, action.y, result)) return;
+    result.accepted = true;
+    if (checkWin(result)) return;
+
+    // A bonus attack only ends the turn when it is the last one
+    if (state.bonusAttacks > 0 && --state.bonusAttacks > 0) return;
+    finishTurn(result);
+}
+
+void GameEngine::powerUp(const Action& action, Result& result) {
+    if (state.bonusAttacks > 0) return; // Already in the middle of a triple shot
+    if (!attacker().powerUp(defender(), action, result)) return;
+    result.accepted = true;
+    if (checkWin(result)) return;
+
+    if (result.bonusAttacks > 0)
+    {
+        state.bonusAttacks = result.bonusAttacks; // Turn continues with the extra attacks
+        return;
+    }
+    finishTurn(result);
+}
+
+void GameEngine::finishTurn(Result& result) {
+    state.bonusAttacks = 0;
+    state.current = 1 - state.current;
+    state.turn++;
+    result.turnOver = true;
+}
+
+bool GameEngine::checkWin(Result& result) {
+    if (!defender().allShipsSunk()) return false;
+    state.phase = Phase::Finished;
+    state.winner = state.current;
+    state.bonusAttacks = 0;
+    result.gameOver = true;
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include "Action.hpp"
+
+using namespace std;
+
+class Player; // Forward declaration
+struct GameSnapshot;
+
+enum class Phase { Placement, Battle, Finished };
+
+// Everything the rules need to know about a match in progress
+struct GameState {
+    Player* players[2];
+    int current;        // Index of the player to move
+    Phase phase;
+    int turn;           // Completed turns in the battle phase
+    int bonusAttacks;   // Attacks left in Steven's triple shot
+    int winner;         // Index of the winner, -1 until the game is over
+};
+
+// The rules of the game with no console I/O. Frontends (the hotseat game,
+// simulators, AIs) turn their input into Actions and read back Results.
+class GameEngine {
+public:
+    GameState state;
+
+    GameEngine();
+    void begin(Player* first, Player* second);  // Start a new match, ships get placed first
+    Result apply(const Action& action);
+
+    // Flat copy of the match for search and rollouts. restore() writes it back into
+    // the players the engine already holds, which must be the same captains.
+    GameSnapshot snapshot() const;
+    void restore(const GameSnapshot& snapshot);
+
+    Player& attacker() const;   // Player to move
+    Player& defender() const;   // Their opponent
+
+private:
+    void place(const Action& action, Result& result);
+    void attack(const Action& action, Result& result);
+    void powerUp(const Action& action, Result& result);
+    void finishTurn(Result& result);
+    bool checkWin(Result& result);
+};
+
+#endif
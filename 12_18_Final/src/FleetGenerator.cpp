@@ -0,0 +1,62 @@
+#include "FleetGenerator.hpp"
+#include <algorithm>
+
+void FleetGenerator::reset(const Mask& blocked, const vector<int>& shipLengths) {
+    if (!ships.empty() && blocked == this->blocked && shipLengths == this->shipLengths) return;
+    this->blocked = blocked;
+    this->shipLengths = shipLengths;
+    oversized = shipLengths.size() > (size_t)MAX_SHIPS;
+    if (oversized)
+    {
+        ships.clear();
+        return;
+    }
+
+    ships.resize(shipLengths.size());
+    for (int id = 0; id < (int)shipLengths.size(); ++id)
+    {
+        ShipSpots& ship = ships[id];
+        ship.id = id;
+        ship.cells.clear();
+        ship.spots.clear();
+        forEachLegalPlacement(blocked, shipLengths[id], [&](const Placement& p) {
+            ship.cells.push_back(p.cells);
+            ship.spots.push_back(&p);
+        });
+    }
+    stable_sort(ships.begin(), ships.end(), [](const ShipSpots& a, const ShipSpots& b) {
+        return a.cells.size() < b.cells.size(); // Fewer spots means a longer ship
+    });
+}
+
+bool FleetGenerator::sample(Rng& rng, vector<const Placement*>& fleet) const {
+    fleet.assign(shipLengths.size(), nullptr);
+    if (oversized) return false;
+    for (const ShipSpots& ship : ships)
+    {
+        if (ship.spots.empty()) return false;   // Nowhere to put this ship at all
+    }
+
+    int picks[MAX_SHIPS];   // reset() turns down bigger fleets
+    for (int attempt = 0; attempt < MAX_TRIES; ++attempt)
+    {
+        Mask used = {};
+        int placed = 0;
+        for (; placed < (int)ships.size(); ++placed)
+        {
+            const ShipSpots& ship = ships[placed];
+            int pick = (int)rng.below((uint32_t)ship.cells.size());
+            if ((ship.cells[pick] & used).any()) break;
+            used |= ship.cells[pick];
+            picks[placed] = pick;
+        }
+        if (placed < (int)ships.size()) continue; // Overlap, draw the whole fleet again
+
+        for (int i = 0; i < (int)ships.size(); ++i)
+        {
+            fleet[ships[i].id] = ships[i].spots[picks[i]];
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#ifndef FLEETGENERATOR_HPP
+#define FLEETGENERATOR_HPP
+
+#include <vector>
+#include "Board.hpp"
+#include "Placement.hpp"
+#include "Rng.hpp"
+#include "Snapshot.hpp"
+
+using namespace std;
+
+// Uniform random fleets for one map and one captain's shipLengths. Every ship
+// picks a spot independently from the spots that avoid the blocked cells, and
+// the whole draw starts over on the first overlap. What survives is uniform
+// over every complete legal layout, unlike placing ships one at a time, which
+// favours layouts where the early ships left the later ones few choices.
+class FleetGenerator {
+public:
+    FleetGenerator() = default;
+    FleetGenerator(const Mask& blocked, const vector<int>& shipLengths) { reset(blocked, shipLengths); }
+    void reset(const Mask& blocked, const vector<int>& shipLengths);   // New map or fleet, a no-op if neither changed
+
+    // Fills fleet[id] for every ship in fleet order. False if no layout turned up
+    // in MAX_TRIES draws (a map too crowded to hold the fleet) or the fleet has
+    // more than MAX_SHIPS ships.
+    bool sample(Rng& rng, vector<const Placement*>& fleet) const;
+
+private:
+    static const int MAX_TRIES = 1 << 20;
+
+    struct ShipSpots {
+        int id;                             // Index in the fleet
+        vector<Mask> cells;                 // Packed next to each other for the overlap test
+        vector<const Placement*> spots;
+    };
+    vector<ShipSpots> ships;                // Longest first, they collide most and end a bad draw soonest
+    Mask blocked;                           // What the spots were built for
+    vector<int> shipLengths;
+    bool oversized = false;                 // More than MAX_SHIPS ships, nothing is ever drawn
+};
+
+#endif
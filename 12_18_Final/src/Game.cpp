@@ -1,9 +1,12 @@
 #include "Game.hpp"
 #include "Player.hpp"
+#include "PowerUpPlanner.hpp"
+#include "Strategy.hpp"
+#include "WinEstimator.hpp"
 
 
-Game::Game() : blitzMode(false) {
-    srand((unsigned)time(0));   // Seed the random number generator
+Game::Game(uint64_t seed, unique_ptr<Clock> clock)
+    : blitzMode(false), terrain(Terrain::openSeas()), seed(seed), rng(seed), oddsRng(Rng(seed).split()), clock(move(clock)), showOdds(false), showHints(false) {
     player1 = new Jenkins();    // Default player1 to Jenkins
     player2 = new Ironsides();  // Default player2 to Ironsides
 }
@@ -33,7 +36,7 @@ void Game::displayRules() {
     cout << endl;
 }
 
-void Game::selectMap(vector<vector<char>>& grid) {
+void Game::selectMap() {
     // User chooses the map: Open Seas or Shattered Sea
     int choice;
     do 
@@ -51,13 +54,14 @@ void Game::selectMap(vector<vector<char>>& grid) {
         
         if (choice == 1) 
         {
+            terrain = Terrain::openSeas();                  // No islands
             cout << "You have selected the map 'The Open Seas'" << endl;
             event("the Open Seas map was chosen");
         } 
         
         else if (choice == 2) 
         {
-            generateShatteredSea(grid);                      // Generate islands
+            terrain = make_shared<const Terrain>(generateShatteredSea()); // Generate islands
             cout << "You have selected the map 'The Shattered Sea'" << endl;
             event("the Shattered Sea map was chosen");
         } 
@@ -72,23 +76,28 @@ void Game::selectMap(vector<vector<char>>& grid) {
 
     // Show the chosen map
     cout << "Here is the selected map:" << endl;
-    printGrid(grid);
+    Grid map;
+    map.islands = terrain->islands;
+    printGrid(map);
     cout << endl;
 }
 
 void Game::start() {
     event("game initialized");
+    event("seed " + to_string(seed)); // Run again with this seed to replay the same islands and draws
 
     displayRules(); // Show rules first                                // Show rules first
     
 
-    // Players share the same map layout: first choose map for player1
-    selectMap(player1->grid);
-    player2->grid = player1->grid;  // Copy map to player2              
+    // Players share the same map layout
+    selectMap();
 
-    // Choose captains for both players
+    // Choose captains for both players, then hand them the shared map
     selectCaptain(player1);
-    selectCaptain(player2);
+    selectCaptain(player2, true);       // Player 2 can be left to the computer
+    player1->terrain = terrain;
+    player2->terrain = terrain;
+    engine.begin(player1, player2);     // Rules run headless, this function is only the console frontend
 
     // Choose game mode (Classic or Blitz)
     selectMode();
@@ -97,28 +106,37 @@ void Game::start() {
     player1->placeShips(*this);
     
     // Handles the screen wipe after player 2 has finished placing their ships
-    cout << "Ships placed please switch players" << endl;
-    this_thread::sleep_for(chrono::seconds(5)); // Gives time to hand over laptop
-    cout << string(100, '\n');
-    this_thread::sleep_for(chrono::seconds(5));
+    if (hotseat()) 
+    {
+        cout << "Ships placed please switch players" << endl;
+        handoff();
+        clock->pause(chrono::seconds(5));
+    }
 
     // Player 2 places ships
     player2->placeShips(*this);
+    if (engine.state.phase != Phase::Battle) 
+    {
+        cout << "A fleet could not be placed on this map, the game is over." << endl;
+        event("game is now terminated");
+        return;
+    }
 
     // Handles the screen wipe after player 2 has finished placing their ships
-    cout << "Ships placed please switch players" << endl;
-    this_thread::sleep_for(chrono::seconds(5)); // Gives time to hand over laptop
-    cout << string(100, '\n');
-    this_thread::sleep_for(chrono::seconds(5));
+    if (hotseat()) 
+    {
+        cout << "Ships placed please switch players" << endl;
+        handoff();
+        clock->pause(chrono::seconds(5));
+    }
 
     // Main game loop: take turns until one player wins
     bool gameOver = false;
-    Player* currentPlayer = player1;
-    Player* opponentPlayer = player2;
 
     while (!gameOver) 
     {
-        auto startTime = chrono::steady_clock::now(); // Track turn start time for blitz
+        Player* currentPlayer = &engine.attacker();     // The engine decides whose turn it is
+        auto startTime = clock->now();    // Track turn start time for blitz
         bool turnComplete = false;
 
         // ASCII banners for opponent and self
@@ -138,23 +156,26 @@ void Game::start() {
         )";
 
         cout << currentPlayer->name << "'s turn:" << endl;
-        cout<<yourself<<endl;                      // Printing player's own grid
-        printGrid(currentPlayer->grid);
-        cout << opponent<<endl;                    // Printing player's guess grid of opponent
-        printGrid(currentPlayer->guessGrid);
+        if (currentPlayer->isComputer()) 
+        {
+            currentPlayer->playTurn(*this);        // Picks and fires on its own, its fleet stays hidden
+            turnComplete = true;
+        } 
+        
+        else 
+        {
+            cout<<yourself<<endl;                      // Printing player's own grid
+            printGrid(currentPlayer->ownView());
+            cout << opponent<<endl;                    // Printing player's guess grid of opponent
+            printGrid(currentPlayer->guessGrid);
+            if (showHints) printHint();
+        }
 
         while (!turnComplete) 
         {
             // Check time limit for blitz mode
-            auto currentTime = chrono::steady_clock::now();
-            auto elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count();
-            if (blitzMode && elapsedTime >= BLITZ_TIME_LIMIT) 
+            if (outOfTime(startTime)) 
             {
-                // If out of time, switch turns
-                cout << "Time's up! Switching turns." << endl; 
-                event("time limit reached, switching");
-                this_thread::sleep_for(chrono::seconds(5));
-                cout << string(100, '\n');
                 turnComplete = true;
                 break;
             }
@@ -172,18 +193,11 @@ void Game::start() {
             if (action == 'a') 
             {
                 // Attack action
-                if (!currentPlayer->takeTurn(*this, *opponentPlayer, blitzMode, startTime)) 
+                if (!currentPlayer->takeTurn(*this, blitzMode, startTime)) 
                 {
                     // If attack invalid or repeated, retry unless time out
-                    currentTime = chrono::steady_clock::now(); //Blitz time tracking
-                    elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count(); //Blitz time tracking
-                    if (blitzMode && elapsedTime >= BLITZ_TIME_LIMIT) 
+                    if (outOfTime(startTime)) 
                     {
-                        // If out of time, switch turns
-                        cout << "Time's up! Switching turns." << endl;
-                        event("time limit reached, switching"); 
-                        this_thread::sleep_for(chrono::seconds(5));
-                        cout << string(100, '\n');
                         turnComplete = true;
                     }
                 } 
@@ -198,18 +212,11 @@ void Game::start() {
             else if (action == 'p') 
             {
                 // Power-up action
-                if (!currentPlayer->usePowerUp(*this, *opponentPlayer, blitzMode, startTime)) 
+                if (!currentPlayer->usePowerUp(*this, blitzMode, startTime)) 
                 {
                     // If power-up failed (invalid or already used), check time and maybe retry if time permits
-                    currentTime = chrono::steady_clock::now();
-                    elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count();
-                    if (blitzMode && elapsedTime >= BLITZ_TIME_LIMIT) 
+                    if (outOfTime(startTime)) 
                     {
-                         // If out of time, switch turns
-                        cout << "Time's up! Switching turns." << endl;
-                        event("time limit reached, switching");
-                        cout << string(50, '\n');
-                        this_thread::sleep_for(chrono::seconds(5));
                         turnComplete = true;
                     }
                 } 
@@ -228,93 +235,48 @@ void Game::start() {
             }
 
             // Final time check if turn not complete
-            if (blitzMode && !turnComplete) 
+            if (!turnComplete && outOfTime(startTime)) 
             {
-                currentTime = chrono::steady_clock::now();
-                elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count();
-                if (elapsedTime >= BLITZ_TIME_LIMIT) 
-                {
-
-                     // If out of time, switch turns
-                    cout << "Time's up! Switching turns." << endl;
-                    event("time limit reached, switching");
-                    this_thread::sleep_for(chrono::seconds(5));
-                    cout << string(100, '\n');
-                    turnComplete = true;
-                }
+                turnComplete = true;
             }
         }
 
+        // A timed out turn never reached the engine, pass it on explicitly
+        if (engine.state.phase == Phase::Battle && &engine.attacker() == currentPlayer) 
+        {
+            engine.apply(Action::endTurn());
+        }
+
         // After turn completes, print updated guess grid
         cout<<"Updated Grid:"<<endl;
         cout << opponent<<endl;
         printGrid(currentPlayer->guessGrid);
+        if (showOdds && engine.state.phase == Phase::Battle) printOdds();
 
         // Check if opponent is defeated
-        if (opponentPlayer->allShipsSunk()) 
+        if (engine.state.phase == Phase::Finished) 
         {
             // Announcing the winner 
             cout << currentPlayer->name << " wins! All opponent ships have been sunk." << endl;
             event("has won the game", currentPlayer->name);
             event("game is now terminated");
-            this_thread::sleep_for(chrono::seconds(20));
+            clock->pause(chrono::seconds(20));     // Leave the result on screen
             gameOver = true;
         } 
         
-        else if (!gameOver) 
+        else if (!gameOver && hotseat()) 
         {
             // If not game over, switch turns
             cout << "Switching turns. Please hand device to other player..." << endl;
-            this_thread::sleep_for(chrono::seconds(5));
-            cout << string(100, '\n');
-            this_thread::sleep_for(chrono::seconds(5));
-            swap(currentPlayer, opponentPlayer);
+            handoff();
+            clock->pause(chrono::seconds(5));
         }
     
     }
 
 }
 
-bool Game::isValidPlacement(Player& player, int x, int y, int length, char direction) {
-    // Check if we can place a ship of 'length' starting at (x,y) in the given direction
-    if (direction == 'h') 
-    {
-        // Horizontal placement
-        if (y + length > GRID_SIZE) return false;   // Goes off right edge
-        for (int j = 0; j < length; ++j) 
-        {
-            if (player.grid[x][y + j] != WATER) return false; // Occupied cell
-        }
-    } 
-    
-    else if (direction == 'v') 
-    {
-        // Vertical placement
-        if (x + length > GRID_SIZE) return false;   // Goes off bottom edge
-        for (int j = 0; j < length; ++j) 
-        {
-            if (player.grid[x + j][y] != WATER) return false; // Occupied cell
-        }
-    } 
-    else if (direction == 'd') 
-    {
-        // Diagonal placement
-        if (x + length > GRID_SIZE || y + length > GRID_SIZE) return false; // Goes off edge
-        for (int j = 0; j < length; ++j) 
-        {
-            if (player.grid[x + j][y + j] != WATER) return false; // Occupied cell
-        }
-    } 
-    
-    else 
-    {
-        return false; // Invalid direction character
-    }
-    
-    return true; // Placement is valid
-}
-
-void Game::printGrid(const vector<vector<char>>& grid) {
+void Game::printGrid(const Grid& grid) {
     // Print the grid with formatting and indices
     string spaces =R"(         )"; // GUI Visual Formatting
     string bottomline=R"(________________________________________)"; // GUI Visual Formatting
@@ -327,12 +289,12 @@ void Game::printGrid(const vector<vector<char>>& grid) {
     }
     cout << endl;
 
-    for (int i = 0; i < (int)grid.size(); ++i) 
+    for (int i = 0; i < GRID_SIZE; ++i) 
     {
         cout <<spaces<< i << " ";                   // Print row index
-        for (char cell : grid[i]) 
+        for (int j = 0; j < GRID_SIZE; ++j) 
         {
-            cout << cell << " ";                    // Print cell symbol
+            cout << grid.at(i, j) << " ";           // Print cell symbol
         }
         cout << endl;
     }
@@ -382,7 +344,7 @@ void Game::selectMode() {
     cout << endl;
 }
 
-void Game::selectCaptain(Player*& player) {
+void Game::selectCaptain(Player*& player, bool offerComputer) {
     // Delete old player and prompt user to pick a new captain
     delete player; // Memory Clearing
     bool check=true;
@@ -391,6 +353,13 @@ void Game::selectCaptain(Player*& player) {
     cout << "1. Old Man Jenkins (5 ships: 1,2,3,4,5)" << endl;
     cout << "2. Old Ironsides (5 ships: 2,2,2,4,5)" << endl;
     cout << "3. Threeven Steven (5 ships: 3,3,3,3,3)" << endl;
+    if (offerComputer) 
+    {
+        // Single player: the opponent is one of the same captains played by the computer
+        cout << "4. Computer playing Old Man Jenkins" << endl;
+        cout << "5. Computer playing Old Ironsides" << endl;
+        cout << "6. Computer playing Threeven Steven" << endl;
+    }
         
     while (check)
     {
@@ -402,30 +371,16 @@ void Game::selectCaptain(Player*& player) {
             cout << "Invalid input. Please enter an integer."<<endl;
         }
         
-        if (choice == 1)  // Pick Jenkins
-        {
-            player = new Jenkins();                  // Assigns current player to have the jenkins class
-            player->shipLengths = {1, 2, 3, 4, 5};   // Assigns the current player jenkins fleet
-            check=false;
-        } 
-        
-        else if (choice == 2) // Pick Ironsides
+        bool computer = offerComputer && choice >= 4 && choice <= 6;
+        player = createCaptain(computer ? choice - 3 : choice, computer); // Captain class with its fleet, null for a bad choice
+        if (player) 
         {
-            player = new Ironsides();                // Assigns current player to have the ironsides class
-            player->shipLengths = {2, 2, 2, 4, 5};   // Assigns the current player ironsides fleet
-            check=false;
-        } 
-        
-        else if (choice == 3) 
-        {
-            player = new Steven();                   // Pick Steven
-            player->shipLengths = {3, 3, 3, 3, 3};   // Assigns the current player jenkins fleet
             check=false;
         } 
         
         else 
         {
-            cout << "Invalid choice, please pick again (1, 2, or 3)." << endl;
+            cout << "Invalid choice, please pick again (" << (offerComputer ? "1 to 6" : "1, 2, or 3") << ")." << endl;
         }
     }
     
@@ -433,12 +388,73 @@ void Game::selectCaptain(Player*& player) {
     event("chosen captain", player->name);
 }
 
-void Game::generateShatteredSea(vector<vector<char>>& grid) {
-    // Randomly scatter islands across the grid
-    int numIslands = rand() % 15 + 5; // Between 5 and 19 islands
-    for (int i = 0; i < numIslands; ++i) {
-        int x = rand() % GRID_SIZE;   // Random row
-        int y = rand() % GRID_SIZE;   // Random column
-        grid[x][y] = ISLAND;          // Place island
+void Game::printOdds() {
+    // Odds meter: one '#' per 5% for player 1, the rest of the bar is player 2
+    WinEstimate odds = WinEstimator().estimate(engine, oddsRng());
+    int filled = (int)(odds.probability * 20 + 0.5);
+    cout << "Odds: " << player1->name << " [" << string(filled, '#') << string(20 - filled, '-') << "] "
+         << player2->name << "  " << (int)(odds.probability * 100 + 0.5) << "% ("
+         << (int)(odds.low * 100 + 0.5) << "-" << (int)(odds.high * 100 + 0.5) << "%) vs "
+         << (int)((1 - odds.probability) * 100 + 0.5) << "%" << endl;
+}
+
+void Game::printHint() {
+    Player& self = engine.attacker();
+    Player& opponent = engine.defender();
+    if (self.usedPowerUp || engine.state.bonusAttacks > 0) return;
+    bool jenkins = dynamic_cast<Jenkins*>(&self) != nullptr;
+    bool ironsides = dynamic_cast<Ironsides*>(&self) != nullptr;
+    if (!jenkins && !ironsides) return;     // Steven's triple shot has nothing to aim
+
+    // Everything this player has seen so far, folded in as one big result
+    DensityMap density;
+    density.reset(terrain->islands, opponent.shipLengths);
+    Result seen = {true, self.guessGrid.hits, self.guessGrid.misses, 0, 0, false, false};
+    for (const Ship& ship : opponent.ships)
+    {
+        if (ship.sunk()) seen.sunkShips |= (uint8_t)(1 << ship.id);
+    }
+    density.record(seen);
+    PowerUpPlan plan = planPowerUps(density, unexploredCells(self));
+
+    ios::fmtflags flags = cout.setf(ios::fixed);
+    streamsize precision = cout.precision(1);
+    if (jenkins)
+    {
+        int cell = plan.bestCenter();
+        cout << "Hint: a power-up centered on (" << cell / GRID_SIZE << ", " << cell % GRID_SIZE << ") expects "
+             << plan.center[cell] << " hits." << endl;
     }
+    else
+    {
+        int line = plan.bestLine();
+        if (line < GRID_SIZE) cout << "Hint: a power-up on row " << line << " expects " << plan.row[line] << " hits." << endl;
+        else cout << "Hint: a power-up on column " << line - GRID_SIZE << " expects " << plan.column[line - GRID_SIZE] << " hits." << endl;
+    }
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+bool Game::outOfTime(chrono::steady_clock::time_point startTime) {
+    if (!blitzMode || clock->secondsSince(startTime) < BLITZ_TIME_LIMIT) return false;
+
+    // If out of time, switch turns
+    cout << "Time's up! Switching turns." << endl;
+    event("time limit reached, switching");
+    handoff();
+    return true;
+}
+
+bool Game::hotseat() const {
+    return !player1->isComputer() && !player2->isComputer();
+}
+
+void Game::handoff() {
+    clock->pause(chrono::seconds(5));   // Gives time to hand over laptop
+    cout << string(100, '\n');          // Wipe the screen before the next player looks
+}
+
+Mask Game::generateShatteredSea() {
+    // Randomly scatter islands across the grid
+    return Terrain::scatterIslands(rng);
 }
@@ -4,19 +4,19 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <thread>
+#include <memory>
+#include "Constants.h"
+#include "Board.hpp"
+#include "Terrain.hpp"
 #include "Player.hpp"
+#include "Engine.hpp"
+#include "Rng.hpp"
+#include "Clock.hpp"
 #include "EventLogger.hpp"
 
 
 using namespace std;
 
-const int GRID_SIZE = 10;
-const char WATER = '~';
-const char ISLAND = 'I';
-const char SHIP = 'S';
-const char HIT = 'X';
-const char MISS = 'O';
 const int BLITZ_TIME_LIMIT = 10;
 
 class Player;
@@ -26,23 +26,35 @@ public:
     Player* player1;
     Player* player2;
     bool blitzMode;
-
-    Game();
+    TerrainPtr terrain;     // Island layout both players share
+    GameEngine engine;      // Rules and turn order, the console code only reads input and prints
+    uint64_t seed;          // Replaying with the same seed repeats every random decision
+    Rng rng;                // Islands, automatic placement and computer shots all draw from this
+    Rng oddsRng;            // Win-odds meter only, so --odds never changes a replay
+    unique_ptr<Clock> clock;    // Blitz timing and handoff pauses, virtual in scripted runs
+    bool showOdds;              // Print a Monte Carlo win-odds meter after every turn
+    bool showHints;             // Suggest the best power-up target on human turns
+
+    explicit Game(uint64_t seed, unique_ptr<Clock> clock = unique_ptr<Clock>(new RealClock()));
     ~Game();
 
     void displayRules();
-    void selectMap(vector<vector<char>>& grid);
+    void selectMap();
     void start();
-    bool isValidPlacement(Player& player, int x, int y, int length, char direction);
-    void printGrid(const vector<vector<char>>& grid);
+    void printGrid(const Grid& grid);
     void selectMode();
-    void selectCaptain(Player*& player);
+    void selectCaptain(Player*& player, bool offerComputer = false);
+    void printOdds();
+    void printHint();
 
     template<typename T>
     bool timedInput(T &var, bool blitz, chrono::steady_clock::time_point startTime);
 
 private:
-    void generateShatteredSea(vector<vector<char>>& grid);
+    Mask generateShatteredSea();
+    bool outOfTime(chrono::steady_clock::time_point startTime);  // Blitz limit check, announces the timeout
+    void handoff();                                             // Blank the screen and wait for the next player
+    bool hotseat() const;                                       // Two humans sharing the screen
 };
 
 template<typename T>
@@ -53,24 +65,22 @@ bool Game::timedInput(T &var, bool blitz, chrono::steady_clock::time_point start
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             cout << "Invalid input. Try again." << endl;
         }
+        clock->inputRead();
         return true;
     }
 
-    auto currentTime = chrono::steady_clock::now();
-    auto elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count();
-
-    if (elapsedTime >= BLITZ_TIME_LIMIT) {
+    if (clock->secondsSince(startTime) >= BLITZ_TIME_LIMIT) {
         cout << "Time's up! Switching turns." << endl;
         return false;
     }
 
-    if (!(cin >> var)) {
+    bool read = (bool)(cin >> var);
+    clock->inputRead();
+    if (!read) {
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        currentTime = chrono::steady_clock::now();
-        elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count();
 
-        if (elapsedTime >= BLITZ_TIME_LIMIT) {
+        if (clock->secondsSince(startTime) >= BLITZ_TIME_LIMIT) {
             cout << "Time's up! Switching turns." << endl;
             return false;
         }
@@ -78,10 +88,7 @@ bool Game::timedInput(T &var, bool blitz, chrono::steady_clock::time_point start
         return timedInput(var, blitz, startTime);
     }
 
-    currentTime = chrono::steady_clock::now();
-    elapsedTime = chrono::duration_cast<chrono::seconds>(currentTime - startTime).count();
-
-    if (elapsedTime >= BLITZ_TIME_LIMIT) {
+    if (clock->secondsSince(startTime) >= BLITZ_TIME_LIMIT) {
         cout << "Time's up! Switching turns." << endl;
         return false;
     }
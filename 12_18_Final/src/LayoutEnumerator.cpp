@@ -0,0 +1,312 @@
+#include "LayoutEnumerator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "Placement.hpp"
+
+// One ship of the search order and every spot it can take on the map
+struct SearchLevel {
+    int length;
+    bool sameAsPrevious;                // Equal ships only take spots after the previous one's
+    vector<const Placement*> spots;     // In (direction, start cell) order
+};
+
+// Read-only description of the search, shared by every thread
+struct SearchPlan {
+    vector<SearchLevel> levels;         // The last one is counted, not enumerated
+    Mask open;                          // Cells a ship may use
+    Mask starts[DIRECTION_COUNT];       // Start cells of the last ship that stay on the board
+    Mask above[CELL_COUNT];             // Bits strictly above each cell index
+    vector<array<Mask, DIRECTION_COUNT>> conflicts; // Per spot of the second-to-last ship, last-ship starts it blocks
+};
+
+// Per-cell totals of masks added one at a time. The masks go into bit-sliced
+// counters (one word per bit of the count), so an add is a few ANDs and XORs.
+class MaskCounter {
+public:
+    array<uint64_t, CELL_COUNT> totals;
+
+    MaskCounter() : slices(), pending(0) { totals.fill(0); }
+
+    void add(const Mask& m) {
+        Mask carry = m;
+        for (int i = 0; carry.any(); ++i)
+        {
+            Mask overflow = slices[i] & carry;  // Ripple-carry across the slices, all words at once
+            slices[i] = slices[i] ^ carry;
+            carry = overflow;
+        }
+        if (++pending == (1 << SLICES) - 1) flush();    // One more could overflow the top slice
+    }
+
+    void flush() {
+        for (int i = 0; i < SLICES; ++i)
+        {
+            slices[i].forEach([&](int x, int y) { totals[x * GRID_SIZE + y] += 1ULL << i; });
+            slices[i] = Mask();
+        }
+        pending = 0;
+    }
+
+private:
+    static const int SLICES = 16;
+    Mask slices[SLICES];
+    int pending;
+};
+
+// One thread's share of the search and its private counters
+class LayoutSearch {
+public:
+    uint64_t layouts;
+    vector<vector<uint64_t>> spotCounts;            // Layouts through each spot, per enumerated level
+    MaskCounter lastStartCounts[DIRECTION_COUNT];   // Start cells of the last ship, over all layouts
+
+    explicit LayoutSearch(const SearchPlan& plan) : layouts(0), plan(plan) {
+        for (const SearchLevel& level : plan.levels) spotCounts.push_back(vector<uint64_t>(level.spots.size(), 0));
+    }
+
+    // Every fleet with the first ship at spot 'first'
+    void runFrom(int first) {
+        const Placement* spot = plan.levels[0].spots[first];
+        uint64_t found = descend(1, spot->cells, first);
+        spotCounts[0][first] += found;
+        layouts += found;
+    }
+
+    void runAll() { layouts += descend(0, Mask(), -1); }
+
+private:
+    const SearchPlan& plan;
+
+    uint64_t descend(int depth, const Mask& used, int previous) {
+        int last = (int)plan.levels.size() - 1;
+        if (depth == last) return countLast(used, previous);
+        if (depth == last - 1) return countLastTwo(used, previous);
+
+        const SearchLevel& level = plan.levels[depth];
+        uint64_t total = 0;
+        for (int i = level.sameAsPrevious ? previous + 1 : 0; i < (int)level.spots.size(); ++i)
+        {
+            const Mask& cells = level.spots[i]->cells;
+            if ((cells & used).any()) continue;
+            uint64_t found = descend(depth + 1, used | cells, i);
+            spotCounts[depth][i] += found;
+            total += found;
+        }
+        return total;
+    }
+
+    // Second-to-last ship: the last ship's starts are worked out once for 'used',
+    // then each spot only knocks out the starts it conflicts with
+    uint64_t countLastTwo(const Mask& used, int previous) {
+        const SearchLevel& level = plan.levels[plan.levels.size() - 2];
+        const SearchLevel& lastLevel = plan.levels.back();
+        Mask starts[DIRECTION_COUNT];
+        int directions = lastStarts(used, starts);
+
+        uint64_t total = 0;
+        for (int i = level.sameAsPrevious ? previous + 1 : 0; i < (int)level.spots.size(); ++i)
+        {
+            const Placement* spot = level.spots[i];
+            if ((spot->cells & used).any()) continue;
+
+            int firstDirection = 0;
+            int previousStart = -1;
+            if (lastLevel.sameAsPrevious)
+            {
+                firstDirection = directionIndex(spot->direction);
+                previousStart = spot->x * GRID_SIZE + spot->y;
+            }
+
+            uint64_t found = 0;
+            for (int d = firstDirection; d < directions; ++d)
+            {
+                Mask open = starts[d].andNot(plan.conflicts[i][d]);
+                if (d == firstDirection && previousStart >= 0) open &= plan.above[previousStart];
+                if (open.none()) continue;
+                found += open.count();
+                lastStartCounts[d].add(open);
+            }
+            spotCounts[plan.levels.size() - 2][i] += found;
+            total += found;
+        }
+        return total;
+    }
+
+    // Start cells of the last ship that fit around 'used', returns how many directions it has
+    int lastStarts(const Mask& used, Mask* starts) const {
+        int length = plan.levels.back().length;
+        Mask freeCells = plan.open.andNot(used);
+        int directions = length == 1 ? 1 : DIRECTION_COUNT;  // A single cell looks the same every way
+        for (int d = 0; d < directions; ++d)
+        {
+            starts[d] = plan.starts[d] & freeCells;
+            for (int j = 1; j < length; ++j) starts[d] &= freeCells.shiftDown(j * DIRECTION_STEPS[d]);
+        }
+        return directions;
+    }
+
+    // Spots for the last ship in one pass per direction: a start cell works when
+    // it and the next length - 1 cells along the direction are all free
+    uint64_t countLast(const Mask& used, int previous) {
+        const SearchLevel& level = plan.levels.back();
+        Mask starts[DIRECTION_COUNT];
+        int directions = lastStarts(used, starts);
+        int firstDirection = 0;
+        int previousStart = -1;
+        if (level.sameAsPrevious && previous >= 0)
+        {
+            const Placement* p = plan.levels[plan.levels.size() - 2].spots[previous];
+            firstDirection = directionIndex(p->direction);
+            previousStart = p->x * GRID_SIZE + p->y;
+        }
+
+        uint64_t total = 0;
+        for (int d = firstDirection; d < directions; ++d)
+        {
+            if (d == firstDirection && previousStart >= 0) starts[d] &= plan.above[previousStart];
+            if (starts[d].none()) continue;
+            total += starts[d].count();
+            lastStartCounts[d].add(starts[d]);
+        }
+        return total;
+    }
+};
+
+static SearchPlan makePlan(const Mask& blocked, const vector<int>& shipLengths) {
+    SearchPlan plan = {};
+    plan.open = Mask::all().andNot(blocked);
+    for (int i = 0; i < CELL_COUNT; ++i)
+    {
+        for (int j = i + 1; j < CELL_COUNT; ++j) plan.above[i].setBit(j);
+    }
+
+    for (int length : shipLengths)
+    {
+        SearchLevel level = {length, false, {}};
+        forEachLegalPlacement(blocked, length, [&](const Placement& p) {
+            if (length > 1 || p.direction == 'h') level.spots.push_back(&p); // One spot per cell for a single-cell ship
+        });
+        plan.levels.push_back(level);
+    }
+
+    // Fewest spots first and the roomiest ship last, so the counted level saves the most work.
+    // Equal ships end up next to each other and take spots in increasing order.
+    stable_sort(plan.levels.begin(), plan.levels.end(), [](const SearchLevel& a, const SearchLevel& b) {
+        if (a.spots.size() != b.spots.size()) return a.spots.size() < b.spots.size();
+        return a.length > b.length;
+    });
+    for (size_t i = 1; i < plan.levels.size(); ++i)
+    {
+        plan.levels[i].sameAsPrevious = plan.levels[i].length == plan.levels[i - 1].length;
+    }
+
+    if (!plan.levels.empty())
+    {
+        int length = plan.levels.back().length;
+        for (int d = 0; d < DIRECTION_COUNT; ++d)
+        {
+            for (int x = 0; x < GRID_SIZE; ++x)
+            {
+                for (int y = 0; y < GRID_SIZE; ++y)
+                {
+                    if (Grid::line(x, y, length, DIRECTIONS[d]).any()) plan.starts[d].setBit(x * GRID_SIZE + y);
+                }
+            }
+        }
+    }
+
+    if (plan.levels.size() >= 2)
+    {
+        // A last-ship start conflicts with a spot when one of its cells lands on the spot
+        int length = plan.levels.back().length;
+        for (const Placement* spot : plan.levels[plan.levels.size() - 2].spots)
+        {
+            array<Mask, DIRECTION_COUNT> conflict = {};
+            for (int d = 0; d < DIRECTION_COUNT; ++d)
+            {
+                spot->cells.forEach([&](int x, int y) {
+                    for (int j = 0; j < length; ++j)
+                    {
+                        int start = x * GRID_SIZE + y - j * DIRECTION_STEPS[d];
+                        if (start >= 0 && plan.starts[d].test(start / GRID_SIZE, start % GRID_SIZE)
+                            && Grid::line(start / GRID_SIZE, start % GRID_SIZE, length, DIRECTIONS[d]).test(x, y))
+                        {
+                            conflict[d].setBit(start);
+                        }
+                    }
+                });
+            }
+            plan.conflicts.push_back(conflict);
+        }
+    }
+    return plan;
+}
+
+LayoutCount countLayouts(const Mask& blocked, const vector<int>& shipLengths, int threads) {
+    LayoutCount result = {};
+    if (shipLengths.empty())
+    {
+        result.layouts = result.orderedLayouts = 1; // The empty fleet fits exactly one way
+        return result;
+    }
+
+    SearchPlan plan = makePlan(blocked, shipLengths);
+    vector<unique_ptr<LayoutSearch>> searches;
+    if (plan.levels.size() == 1)
+    {
+        searches.emplace_back(new LayoutSearch(plan));
+        searches[0]->runAll();
+    }
+    else
+    {
+        // Threads take first-ship spots off a shared counter until none are left
+        int workerCount = threads < 1 ? 1 : threads;
+        atomic<int> next(0);
+        int firstSpots = (int)plan.levels[0].spots.size();
+        vector<thread> workers;
+        for (int t = 0; t < workerCount; ++t) searches.emplace_back(new LayoutSearch(plan));
+        for (int t = 0; t < workerCount; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                for (int first = next++; first < firstSpots; first = next++) searches[t]->runFrom(first);
+            });
+        }
+        for (thread& worker : workers) worker.join();
+    }
+
+    // Spread the per-spot totals back onto the cells
+    int lastLevel = (int)plan.levels.size() - 1;
+    for (auto& search : searches)
+    {
+        result.layouts += search->layouts;
+        for (int level = 0; level < lastLevel; ++level)
+        {
+            for (size_t i = 0; i < plan.levels[level].spots.size(); ++i)
+            {
+                uint64_t count = search->spotCounts[level][i];
+                if (count == 0) continue;
+                plan.levels[level].spots[i]->cells.forEach([&](int x, int y) { result.cellCounts[x * GRID_SIZE + y] += count; });
+            }
+        }
+        for (int d = 0; d < DIRECTION_COUNT; ++d)
+        {
+            search->lastStartCounts[d].flush();
+            for (int start = 0; start < CELL_COUNT; ++start)
+            {
+                uint64_t count = search->lastStartCounts[d].totals[start];
+                for (int j = 0; count && j < plan.levels.back().length; ++j) result.cellCounts[start + j * DIRECTION_STEPS[d]] += count;
+            }
+        }
+    }
+
+    // Ordered fleets tell equal ships apart: k! orderings per group of k
+    result.orderedLayouts = result.layouts;
+    for (size_t i = 0, run = 1; i < plan.levels.size(); ++i)
+    {
+        run = plan.levels[i].sameAsPrevious ? run + 1 : 1;
+        result.orderedLayouts *= run;
+    }
+    return result;
+}
@@ -0,0 +1,28 @@
+#ifndef LAYOUTENUMERATOR_HPP
+#define LAYOUTENUMERATOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Board.hpp"
+
+using namespace std;
+
+// Exact totals over every legal layout of one fleet on one map
+struct LayoutCount {
+    uint64_t layouts;           // Distinct fleets, swapping two ships of the same length is the same fleet
+    uint64_t orderedLayouts;    // Fleets as placed ship by ship, layouts x k! per group of k equal ships
+    array<uint64_t, CELL_COUNT> cellCounts; // Layouts with a ship on each cell
+
+    // Share of all layouts with a ship on (x, y), a targeting prior before any shot is fired
+    double frequency(int x, int y) const { return layouts ? (double)cellCounts[x * GRID_SIZE + y] / layouts : 0.0; }
+};
+
+// Backtracking over the placement masks, split across 'threads' by the first
+// ship's position. Ships of the same length only go down in increasing
+// placement order, so each distinct fleet is visited once instead of k! times.
+// The last ship is never enumerated: its spots are counted straight off the
+// free-cell bitboard with shifts and ANDs.
+LayoutCount countLayouts(const Mask& blocked, const vector<int>& shipLengths, int threads);
+
+#endif
@@ -0,0 +1,201 @@
+#include "Mcts.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "OpeningBook.hpp"
+#include "Player.hpp"
+#include "PowerUpPlanner.hpp"
+#include "Snapshot.hpp"
+#include "WinEstimator.hpp"
+
+// Chance per rollout turn of 1 in this that a side spends its power-up
+static const uint32_t ROLLOUT_POWER_UP_ODDS = 8;
+
+MctsPlanner::MctsPlanner()
+    : budgetMilliseconds(50), iterations(0), threads(1), exploration(0.7), attackCandidates(8), powerUpCandidates(4), maxTurns(1000) {}
+
+vector<Action> MctsPlanner::candidates(const GameEngine& engine, const DensityMap& density) const {
+    const Player& self = engine.attacker();
+    Mask open = unexploredCells(self);
+    vector<Action> moves;
+
+    // Target tally while it still points at open cells, hunt tally otherwise
+    bool aiming = false;
+    if (density.targeting())
+    {
+        open.forEach([&](int x, int y) { aiming = aiming || density.targetScore(x * GRID_SIZE + y) > 0; });
+    }
+    auto weight = [&](int cell) { return aiming ? density.targetScore(cell) : density.huntScore(cell); };
+
+    // Attacks: the best few cells
+    vector<pair<uint64_t, int>> cells;
+    open.forEach([&](int x, int y) { cells.push_back({weight(x * GRID_SIZE + y), x * GRID_SIZE + y}); });
+    int keep = min(attackCandidates, (int)cells.size());
+    partial_sort(cells.begin(), cells.begin() + keep, cells.end(), greater<pair<uint64_t, int>>());
+    for (int i = 0; i < keep; ++i) moves.push_back(Action::attack(cells[i].second / GRID_SIZE, cells[i].second % GRID_SIZE));
+
+    // Power-ups, when there is one to spend
+    if (self.usedPowerUp || engine.state.bonusAttacks > 0) return moves;
+    if (const Steven* steven = dynamic_cast<const Steven*>(&self))
+    {
+        if (steven->powercounter <= 3) moves.push_back(Action::powerUp());
+        return moves;
+    }
+
+    // Jenkins center cell, or Ironsides row (0-9) / column (10-19), by expected hits
+    PowerUpPlan scores = planPowerUps(density, open);
+    vector<pair<double, int>> areas;
+    bool jenkins = dynamic_cast<const Jenkins*>(&self) != nullptr;
+    bool ironsides = dynamic_cast<const Ironsides*>(&self) != nullptr;
+    for (int i = 0; jenkins && i < CELL_COUNT; ++i) areas.push_back({scores.center[i], i});
+    for (int i = 0; ironsides && i < 2 * GRID_SIZE; ++i)
+    {
+        areas.push_back({i < GRID_SIZE ? scores.row[i] : scores.column[i - GRID_SIZE], i});
+    }
+    keep = min(powerUpCandidates, (int)areas.size());
+    partial_sort(areas.begin(), areas.begin() + keep, areas.end(), greater<pair<double, int>>());
+    for (int i = 0; i < keep; ++i)
+    {
+        int a = areas[i].second;
+        if (jenkins) moves.push_back(Action::powerUp(a / GRID_SIZE, a % GRID_SIZE));
+        else moves.push_back(a < GRID_SIZE ? Action::powerUp(a, 0, 'r') : Action::powerUp(0, a - GRID_SIZE, 'c'));
+    }
+    return moves;
+}
+
+Action MctsPlanner::plan(const GameEngine& engine, const DensityMap& density, uint64_t seed, vector<MctsChild>* stats) const {
+    vector<Action> moves = candidates(engine, density);
+    if (moves.empty()) return Action::endTurn();
+
+    vector<MctsChild> children;
+    for (const Action& move : moves) children.push_back({move, 0.0, 0});
+    auto deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(budgetMilliseconds * 1000));
+
+    // Root parallel: a private root per thread, summed at the end
+    int workerCount = threads < 1 ? 1 : threads;
+    vector<vector<MctsChild>> roots(workerCount, children);
+    Rng master(seed);
+    auto quota = [&](int t) { return iterations > 0 ? iterations / workerCount + (t < iterations % workerCount) : -1LL; };
+    if (workerCount == 1)
+    {
+        search(engine, roots[0], master.split(), deadline, quota(0));
+    }
+    else
+    {
+        vector<thread> workers;
+        for (int t = 0; t < workerCount; ++t)
+        {
+            Rng rng = master.split();   // Own stream per thread
+            workers.emplace_back([&, t, rng]() { search(engine, roots[t], rng, deadline, quota(t)); });
+        }
+        for (thread& worker : workers) worker.join();
+    }
+
+    int best = 0;
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        for (const vector<MctsChild>& root : roots)
+        {
+            children[i].reward += root[i].reward;
+            children[i].visits += root[i].visits;
+        }
+        // Most visited wins, the better average breaks a tie
+        const MctsChild& a = children[i];
+        const MctsChild& b = children[best];
+        if (a.visits > b.visits || (a.visits == b.visits && a.reward > b.reward)) best = (int)i;
+    }
+    if (stats) *stats = children;
+    return children[best].action;
+}
+
+void MctsPlanner::search(const GameEngine& engine, vector<MctsChild>& children, Rng rng,
+                         chrono::steady_clock::time_point deadline, long long quota) const {
+    // Private players to play on, every iteration restores the root position into them
+    unique_ptr<Player> players[2] = {unique_ptr<Player>(engine.state.players[0]->clone()),
+                                     unique_ptr<Player>(engine.state.players[1]->clone())};
+    GameEngine game = engine;
+    game.state.players[0] = players[0].get();
+    game.state.players[1] = players[1].get();
+    GameSnapshot root = engine.snapshot();
+    int side = engine.state.current;
+    vector<const Placement*> fleet;
+
+    // A skipped iteration still counts against the quota, so a fleet that never fits cannot stall it
+    for (long long total = 0, tried = 0; quota >= 0 ? tried < quota : chrono::steady_clock::now() < deadline; ++tried)
+    {
+        // UCB1, every candidate is tried once first
+        int pick = 0;
+        double bestScore = -1.0;
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            const MctsChild& child = children[i];
+            if (child.visits == 0)
+            {
+                pick = (int)i;
+                break;
+            }
+            double score = child.reward / child.visits + exploration * sqrt(log((double)total) / child.visits);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                pick = (int)i;
+            }
+        }
+
+        // Determinize: the opponent's fleet redrawn to fit what we have seen, ours is known
+        game.restore(root);
+        Player& opponent = *game.state.players[1 - side];
+        if (!sampleHiddenFleet(opponent, *game.state.players[side], rng, fleet)) continue;  // Never play on the real layout
+        opponent.redeployFleet(fleet);
+
+        children[pick].reward += rollout(game, children[pick].action, side, rng);
+        children[pick].visits++;
+        ++total;
+    }
+}
+
+double MctsPlanner::rollout(GameEngine& game, const Action& first, int side, Rng& rng) const {
+    if (!game.apply(first).accepted) return 0.0;    // Candidates are legal, this is only a guard
+
+    // Both sides: parity fire, the power-up at a random moment aimed where the parity
+    // bot was going to shoot (Jenkins around that cell, Ironsides along its row or column)
+    ParityStrategy fire[2] = {ParityStrategy(rng), ParityStrategy(rng)};
+    while (game.state.phase == Phase::Battle && game.state.turn < maxTurns)
+    {
+        ParityStrategy& policy = fire[game.state.current];
+        Action action = policy.chooseAction(game);
+        if (!game.attacker().usedPowerUp && game.state.bonusAttacks == 0 && rng.below(ROLLOUT_POWER_UP_ODDS) == 0)
+        {
+            Action powerUp = Action::powerUp(action.x, action.y, rng.below(2) ? 'r' : 'c');
+            Result result = game.apply(powerUp);
+            if (result.accepted)
+            {
+                policy.observe(game, powerUp, result);
+                continue;
+            }
+        }
+
+        Result result = game.apply(action);
+        if (!result.accepted)
+        {
+            game.apply(Action::endTurn());  // Never spin in place
+            continue;
+        }
+        policy.observe(game, action, result);
+    }
+    if (game.state.winner < 0) return 0.5;
+    return game.state.winner == side ? 1.0 : 0.0;
+}
+
+Action MctsStrategy::chooseAction(const GameEngine& engine) {
+    if (!ready)
+    {
+        density.reset(engine.attacker().terrain->islands, engine.defender().shipLengths);
+        ready = true;
+    }
+    int cell = OpeningBook::shared().nextShot(engine.attacker(), engine.defender().shipLengths);
+    if (cell >= 0) return Action::attack(cell / GRID_SIZE, cell % GRID_SIZE);   // Still on the book, no search needed
+    return planner.plan(engine, density, rng());
+}
@@ -0,0 +1,73 @@
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "DensityMap.hpp"
+#include "Engine.hpp"
+#include "Rng.hpp"
+#include "Strategy.hpp"
+
+using namespace std;
+
+// Running totals for one candidate move at the root
+struct MctsChild {
+    Action action;
+    double reward;      // Sum of playout results, 1 for a win, 0.5 for a draw
+    long long visits;
+};
+
+// Monte Carlo tree search over the player to move's attacks and power-ups.
+// The tree is the root and its candidate moves: below it every hit or miss
+// splits the player's information, so deeper nodes would hardly ever be seen
+// twice within a move's budget. Candidates are picked by UCB1. Each iteration
+// determinizes the opponent's hidden fleet (redrawn to fit everything seen so
+// far, an iteration whose draw fails is skipped), plays the candidate, and
+// rolls the game out with parity fire and a power-up at a random moment.
+// Every thread grows its own root on its own copy of the game, and the visit
+// counts are summed when the budget is spent.
+class MctsPlanner {
+public:
+    double budgetMilliseconds;  // Wall time per decision
+    long long iterations;       // Iterations per decision instead of the wall time when > 0, same seed same move
+    int threads;                // Rollout threads, 1 searches on the calling thread
+    double exploration;         // UCB1 constant, rewards are in [0, 1]
+    int attackCandidates;       // Best cells by density that enter the search
+    int powerUpCandidates;      // Best Jenkins centers / Ironsides lines that enter the search
+    int maxTurns;               // Rollouts past this count as a draw
+
+    MctsPlanner();
+
+    // Most visited candidate, 'stats' (if given) receives every candidate's totals
+    Action plan(const GameEngine& engine, const DensityMap& density, uint64_t seed, vector<MctsChild>* stats = nullptr) const;
+
+    vector<Action> candidates(const GameEngine& engine, const DensityMap& density) const;
+
+private:
+    // Runs until 'deadline', or for exactly 'quota' iterations when quota >= 0
+    void search(const GameEngine& engine, vector<MctsChild>& children, Rng rng,
+                chrono::steady_clock::time_point deadline, long long quota) const;
+    double rollout(GameEngine& game, const Action& first, int side, Rng& rng) const;
+};
+
+// Strategy wrapper: keeps the DensityMap up to date and asks the planner every move
+// once the opening book runs out (first hit, power-up or end of the line).
+// Name "mcts" uses the defaults, "mcts:MS" or "mcts:MS:THREADS" sets the budget,
+// "mcts:Ni" or "mcts:Ni:THREADS" gives every move N iterations instead.
+class MctsStrategy : public Strategy {
+public:
+    MctsPlanner planner;
+
+    explicit MctsStrategy(Rng& rng) : rng(rng), ready(false) {}
+    void reset() override { ready = false; }
+    Action chooseAction(const GameEngine& engine) override;
+    void observe(const GameEngine&, const Action&, const Result& result) override { density.record(result); }
+
+private:
+    Rng& rng;
+    DensityMap density;
+    bool ready;
+};
+
+#endif
@@ -0,0 +1,221 @@
+#include "OpeningBook.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "FleetGenerator.hpp"
+#include "Player.hpp"
+#include "Terrain.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File layout: this header, then 'count' entries sorted by key
+struct BookHeader {
+    char magic[4];
+    uint32_t byteOrder;     // BOOK_BYTE_ORDER as the writer saw it
+    uint32_t entryBytes;    // sizeof(BookEntry), catches a build with another BOOK_DEPTH
+    uint32_t count;
+};
+
+static const char BOOK_MAGIC[4] = {'B', 'S', 'O', 'B'};
+static const uint32_t BOOK_BYTE_ORDER = 0x01020304;
+
+static bool sameFleet(const BookEntry& entry, const vector<int>& fleet) {
+    if (fleet.size() > (size_t)MAX_SHIPS) return false;
+    for (int i = 0; i < MAX_SHIPS; ++i)
+    {
+        int length = i < (int)fleet.size() ? fleet[i] : 0;
+        if (entry.fleet[i] != length) return false;
+    }
+    return true;
+}
+
+OpeningBook::OpeningBook() : table(nullptr), count(0), view(nullptr), bytes(0), mapping(nullptr) {}
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+OpeningBook& OpeningBook::shared() {
+    static OpeningBook book;
+    return book;
+}
+
+bool OpeningBook::open(const string& path) {
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(BookHeader))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);      // The mapping keeps the file open
+    if (!map) return false;
+    void* data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(map);
+        return false;
+    }
+    mapping = map;
+    bytes = (size_t)size.QuadPart;
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < (off_t)sizeof(BookHeader))
+    {
+        ::close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);          // The mapping keeps the file open
+    if (data == MAP_FAILED) return false;
+    bytes = (size_t)info.st_size;
+#endif
+    view = data;
+
+    const BookHeader* header = (const BookHeader*)view;
+    if (memcmp(header->magic, BOOK_MAGIC, 4) != 0 || header->byteOrder != BOOK_BYTE_ORDER
+        || header->entryBytes != sizeof(BookEntry) || sizeof(BookHeader) + header->count * sizeof(BookEntry) > bytes)
+    {
+        close();            // Not a book of this build
+        return false;
+    }
+    table = (const BookEntry*)((const char*)view + sizeof(BookHeader));
+    count = header->count;
+    return true;
+}
+
+void OpeningBook::close() {
+    if (view)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(view);
+        CloseHandle((HANDLE)mapping);
+#else
+        munmap(view, bytes);
+#endif
+    }
+    table = nullptr;
+    count = 0;
+    view = nullptr;
+    bytes = 0;
+    mapping = nullptr;
+}
+
+uint64_t OpeningBook::keyOf(const Mask& islands, const vector<int>& fleet) {
+    uint64_t key = Terrain::hashOf(islands);
+    for (int length : fleet)
+    {
+        uint64_t state = key ^ (uint64_t)length;
+        key = splitMix64(state);
+    }
+    return key;
+}
+
+const BookEntry* OpeningBook::find(const Mask& islands, const vector<int>& fleet) const {
+    uint64_t key = keyOf(islands, fleet);
+    const BookEntry* entry = lower_bound(begin(), end(), key, [](const BookEntry& e, uint64_t k) { return e.key < k; });
+    for (; entry != end() && entry->key == key; ++entry)
+    {
+        if (entry->islands == islands && sameFleet(*entry, fleet)) return entry;
+    }
+    return nullptr;
+}
+
+int OpeningBook::nextShot(const Player& self, const vector<int>& fleet) const {
+    if (count == 0 || self.guessGrid.hits.any()) return -1;
+    const BookEntry* entry = find(self.terrain->islands, fleet);
+    if (!entry) return -1;
+
+    // On the line only if the misses so far are exactly its first shots
+    Mask misses = self.guessGrid.misses;
+    int played = misses.count();
+    if (played >= entry->shotCount) return -1;
+    Mask line = {};
+    for (int i = 0; i < played; ++i) line.setBit(entry->shots[i]);
+    return line == misses ? entry->shots[played] : -1;
+}
+
+BookEntry OpeningBook::build(const Mask& islands, const vector<int>& fleet, int depth, int samples, Rng& rng) {
+    BookEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = keyOf(islands, fleet);
+    entry.islands = islands;
+    for (int i = 0; i < (int)fleet.size() && i < MAX_SHIPS; ++i) entry.fleet[i] = (uint8_t)fleet[i];
+    if (depth > BOOK_DEPTH) depth = BOOK_DEPTH;
+
+    // Drawing with the misses blocked is drawing from the layouts that fit them
+    Mask blocked = islands;
+    FleetGenerator generator;
+    vector<const Placement*> layout;
+    for (int shot = 0; shot < depth; ++shot)
+    {
+        generator.reset(blocked, fleet);
+        int covered[CELL_COUNT] = {};
+        for (int s = 0; s < samples; ++s)
+        {
+            if (!generator.sample(rng, layout)) return entry;   // The fleet no longer fits, the line ends here
+            for (const Placement* p : layout) p->cells.forEach([&](int x, int y) { covered[x * GRID_SIZE + y]++; });
+        }
+
+        int best = -1;
+        Mask::all().andNot(blocked).forEach([&](int x, int y) {
+            int cell = x * GRID_SIZE + y;
+            if (best < 0 || covered[cell] > covered[best]) best = cell;
+        });
+        if (best < 0) break;
+        entry.shots[entry.shotCount++] = (uint8_t)best;
+        blocked.setBit(best);
+    }
+    return entry;
+}
+
+bool OpeningBook::write(const string& path, vector<BookEntry> entries) {
+    // Later entries win, then the survivors go in key order
+    vector<BookEntry> kept;
+    for (int i = (int)entries.size() - 1; i >= 0; --i)
+    {
+        bool replaced = false;
+        for (const BookEntry& e : kept)
+        {
+            replaced = replaced || (e.key == entries[i].key && e.islands == entries[i].islands
+                                    && memcmp(e.fleet, entries[i].fleet, sizeof(e.fleet)) == 0);
+        }
+        if (!replaced) kept.push_back(entries[i]);
+    }
+    stable_sort(kept.begin(), kept.end(), [](const BookEntry& a, const BookEntry& b) { return a.key < b.key; });
+
+    // Written beside the old book and swapped in, a reader never sees half a file
+    string temporary = path + ".tmp";
+    {
+        ofstream file(temporary, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+        BookHeader header = {};
+        memcpy(header.magic, BOOK_MAGIC, 4);
+        header.byteOrder = BOOK_BYTE_ORDER;
+        header.entryBytes = sizeof(BookEntry);
+        header.count = (uint32_t)kept.size();
+        file.write((const char*)&header, sizeof(header));
+        if (!kept.empty()) file.write((const char*)kept.data(), (streamsize)(kept.size() * sizeof(BookEntry)));
+        if (!file) return false;
+    }
+#if defined(_WIN32)
+    remove(path.c_str());   // Windows rename will not replace a file
+#endif
+    return rename(temporary.c_str(), path.c_str()) == 0;
+}
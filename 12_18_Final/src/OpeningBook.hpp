@@ -0,0 +1,75 @@
+#ifndef OPENINGBOOK_HPP
+#define OPENINGBOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Board.hpp"
+#include "Rng.hpp"
+#include "Snapshot.hpp"
+
+using namespace std;
+
+class Player;
+
+const int BOOK_DEPTH = 15;              // Shots stored per line, keeps an entry at 48 bytes
+const int BOOK_SAMPLES = 1000000;       // Layouts drawn per shot when building
+
+// The opening line for one map and one opponent fleet. Until the first hit every
+// shot only depends on which cells missed, so the line is the best shot after
+// zero misses, then after that one missed, and so on.
+struct BookEntry {
+    uint64_t key;                       // OpeningBook::keyOf(islands, fleet), the sort order of the file
+    Mask islands;
+    uint8_t fleet[MAX_SHIPS];           // Opponent ship lengths, 0 past the last ship
+    uint8_t shotCount;
+    uint8_t shots[BOOK_DEPTH];          // Cell indexes in firing order
+};
+
+static_assert(is_trivially_copyable<BookEntry>::value, "BookEntry is mapped straight from the file");
+
+// Precomputed opening lines, read from a memory-mapped file so opening it costs
+// nothing until a line is looked up. The file is a small header and the entries
+// sorted by key, looked up by binary search. It is written in the machine's own
+// byte order and a file from the other order is turned down.
+class OpeningBook {
+public:
+    OpeningBook();
+    ~OpeningBook();
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    bool open(const string& path);      // False if missing or not a book, the book is then empty
+    void close();
+    size_t size() const { return count; }
+    const BookEntry* begin() const { return table; }
+    const BookEntry* end() const { return table + count; }
+
+    const BookEntry* find(const Mask& islands, const vector<int>& fleet) const;
+
+    // Next shot of the line while every shot so far missed and followed it, -1 once off the book
+    int nextShot(const Player& self, const vector<int>& fleet) const;
+
+    // The book the computer players read, opened once at startup
+    static OpeningBook& shared();
+
+    static uint64_t keyOf(const Mask& islands, const vector<int>& fleet);
+
+    // Greedy line: each shot is the open cell the most sampled layouts cover, given
+    // that every earlier shot missed. Layouts are uniform over the legal ones.
+    static BookEntry build(const Mask& islands, const vector<int>& fleet, int depth, int samples, Rng& rng);
+
+    // Sorts by key and replaces the file, entries for the same map and fleet keep the last one
+    static bool write(const string& path, vector<BookEntry> entries);
+
+private:
+    const BookEntry* table;
+    size_t count;
+    void* view;                         // Start of the mapping
+    size_t bytes;
+    void* mapping;                      // Windows mapping handle, unused elsewhere
+};
+
+#endif
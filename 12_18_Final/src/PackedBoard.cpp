@@ -0,0 +1,127 @@
+#include "PackedBoard.hpp"
+
+// Archive layout: magic, rows, cols, bits per cell, island mask words, then fixed-size boards
+static const char ARCHIVE_MAGIC[4] = {'B', 'S', 'P', 'K'};
+static const int HEADER_BYTES = 4 + 3 + Mask::WORDS * 8;
+
+static const uint8_t CODE_WATER = 0;
+static const uint8_t CODE_SHIP = 1;
+static const uint8_t CODE_HIT = 2;
+static const uint8_t CODE_MISS = 3;
+
+PackedBoard PackedBoard::pack(const Grid& grid) {
+    PackedBoard packed = {};
+    for (int i = 0; i < CELL_COUNT; ++i)
+    {
+        int x = i / GRID_SIZE, y = i % GRID_SIZE;
+        uint8_t code = CODE_WATER;
+        if (grid.ships.test(x, y)) code = CODE_SHIP;
+        else if (grid.hits.test(x, y)) code = CODE_HIT;
+        else if (grid.misses.test(x, y)) code = CODE_MISS;
+
+        int bit = i * BITS_PER_CELL;
+        packed.bytes[bit / 8] |= (uint8_t)(code << (bit % 8)); // Two-bit codes never straddle a byte
+    }
+    return packed;
+}
+
+Grid PackedBoard::unpack(const Terrain& terrain) const {
+    Grid grid;
+    for (int i = 0; i < CELL_COUNT; ++i)
+    {
+        int bit = i * BITS_PER_CELL;
+        uint8_t code = (bytes[bit / 8] >> (bit % 8)) & 3;
+        if (code == CODE_SHIP) grid.ships.setBit(i);
+        else if (code == CODE_HIT) grid.hits.setBit(i);
+        else if (code == CODE_MISS) grid.misses.setBit(i);
+    }
+    grid.islands = terrain.islands;
+    return grid;
+}
+
+char PackedBoard::at(int x, int y) const {
+    int bit = (x * GRID_SIZE + y) * BITS_PER_CELL;
+    uint8_t code = (bytes[bit / 8] >> (bit % 8)) & 3;
+    const char symbols[4] = {WATER, SHIP, HIT, MISS};
+    return symbols[code];
+}
+
+BoardArchiveWriter::BoardArchiveWriter(const string& path, const Terrain& terrain)
+    : file(path, ios::binary | ios::trunc) {
+    if (!file.is_open()) return;
+
+    // Header: magic, board shape, then the islands so each record can skip them
+    file.write(ARCHIVE_MAGIC, 4);
+    const uint8_t shape[3] = {(uint8_t)GRID_SIZE, (uint8_t)GRID_SIZE, (uint8_t)BITS_PER_CELL};
+    file.write((const char*)shape, 3);
+    for (int k = 0; k < Mask::WORDS; ++k)
+    {
+        uint8_t word[8];
+        for (int b = 0; b < 8; ++b) word[b] = (uint8_t)(terrain.islands.w[k] >> (8 * b)); // Little-endian on every platform
+        file.write((const char*)word, 8);
+    }
+}
+
+void BoardArchiveWriter::append(const Grid& grid) {
+    append(PackedBoard::pack(grid));
+}
+
+void BoardArchiveWriter::append(const PackedBoard& board) {
+    file.write((const char*)board.bytes, PACKED_BOARD_BYTES);
+}
+
+void BoardArchiveWriter::write(size_t index, const PackedBoard* boards, size_t count) {
+    file.seekp((streamoff)HEADER_BYTES + (streamoff)index * PACKED_BOARD_BYTES);
+    file.write((const char*)boards, (streamsize)(count * PACKED_BOARD_BYTES));
+}
+
+bool BoardArchiveWriter::finish() {
+    file.flush();
+    return file.good();
+}
+
+BoardArchiveReader::BoardArchiveReader(const string& path)
+    : file(path, ios::binary), valid(false), boardCount(0), map(Terrain::openSeas()) {
+    if (!file.is_open()) return;
+
+    char magic[4];
+    uint8_t shape[3];
+    file.read(magic, 4);
+    file.read((char*)shape, 3);
+    if (!file || string(magic, 4) != string(ARCHIVE_MAGIC, 4)
+        || shape[0] != GRID_SIZE || shape[1] != GRID_SIZE || shape[2] != BITS_PER_CELL)
+    {
+        return; // Not an archive of this board size
+    }
+
+    Mask islands = {};
+    for (int k = 0; k < Mask::WORDS; ++k)
+    {
+        uint8_t word[8];
+        file.read((char*)word, 8);
+        for (int b = 0; b < 8; ++b) islands.w[k] |= (uint64_t)word[b] << (8 * b);
+    }
+    if (!file) return;
+    map = make_shared<const Terrain>(islands);
+
+    // Records are fixed size, so the file length gives the count
+    file.seekg(0, ios::end);
+    streamoff length = file.tellg();
+    boardCount = (size_t)((length - HEADER_BYTES) / PACKED_BOARD_BYTES);
+    valid = true;
+}
+
+bool BoardArchiveReader::read(size_t index, PackedBoard& board) {
+    if (!valid || index >= boardCount) return false;
+    file.clear();
+    file.seekg((streamoff)HEADER_BYTES + (streamoff)index * PACKED_BOARD_BYTES);
+    file.read((char*)board.bytes, PACKED_BOARD_BYTES);
+    return (bool)file;
+}
+
+bool BoardArchiveReader::read(size_t index, Grid& grid) {
+    PackedBoard board;
+    if (!read(index, board)) return false;
+    grid = board.unpack(*map);
+    return true;
+}
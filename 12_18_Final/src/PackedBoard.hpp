@@ -0,0 +1,58 @@
+#ifndef PACKEDBOARD_HPP
+#define PACKEDBOARD_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "Board.hpp"
+#include "Terrain.hpp"
+
+using namespace std;
+
+// Islands are shared terrain, so a player's own state only needs four symbols
+// (WATER, SHIP, HIT, MISS) and fits in two bits per cell.
+const int BITS_PER_CELL = 2;
+const int PACKED_BOARD_BYTES = (CELL_COUNT * BITS_PER_CELL + 7) / 8;   // 25 bytes instead of 100 chars
+
+// One board's ships/hits/misses in archive form
+struct PackedBoard {
+    uint8_t bytes[PACKED_BOARD_BYTES];
+
+    static PackedBoard pack(const Grid& grid);
+    Grid unpack(const Terrain& terrain) const;  // Islands come back from the terrain
+    char at(int x, int y) const;                // Read one cell without unpacking the rest
+};
+
+// Appends packed boards to a file that starts with the map they were played on
+class BoardArchiveWriter {
+public:
+    BoardArchiveWriter(const string& path, const Terrain& terrain);
+    bool isOpen() const { return file.is_open(); }
+    void append(const Grid& grid);
+    void append(const PackedBoard& board);
+    // Stores 'count' boards from position 'index' on, in any order; a gap reads as empty water until filled
+    void write(size_t index, const PackedBoard* boards, size_t count);
+    bool finish();                      // Flushes, false if any write failed
+
+private:
+    ofstream file;
+};
+
+// Reads any stored board by index with a single seek, no need to decode the others
+class BoardArchiveReader {
+public:
+    explicit BoardArchiveReader(const string& path);
+    bool isOpen() const { return valid; }
+    size_t size() const { return boardCount; }
+    const Terrain& terrain() const { return *map; }
+    bool read(size_t index, PackedBoard& board);
+    bool read(size_t index, Grid& grid);
+
+private:
+    ifstream file;
+    bool valid;
+    size_t boardCount;
+    TerrainPtr map;
+};
+
+#endif
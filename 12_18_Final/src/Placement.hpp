@@ -0,0 +1,147 @@
+#ifndef PLACEMENT_HPP
+#define PLACEMENT_HPP
+
+#include <cstdint>
+#include "Board.hpp"
+
+using namespace std;
+
+const int MAX_SHIP_LENGTH = 5;      // Longest ship in any captain's fleet
+const int DIRECTION_COUNT = 3;
+constexpr char DIRECTIONS[DIRECTION_COUNT] = {'h', 'v', 'd'};
+constexpr int DIRECTION_STEPS[DIRECTION_COUNT] = {1, GRID_SIZE, GRID_SIZE + 1};  // Bit distance between neighbouring ship cells
+
+// Index of 'h', 'v' and 'd' in DIRECTIONS for every char, DIRECTION_COUNT for the rest
+struct DirectionLookup {
+    int8_t index[256];
+};
+
+constexpr DirectionLookup buildDirectionLookup() {
+    DirectionLookup lookup = {};
+    for (int c = 0; c < 256; ++c) lookup.index[c] = DIRECTION_COUNT;
+    for (int d = 0; d < DIRECTION_COUNT; ++d) lookup.index[(uint8_t)DIRECTIONS[d]] = (int8_t)d;
+    return lookup;
+}
+
+inline constexpr DirectionLookup DIRECTION_LOOKUP = buildDirectionLookup();
+
+constexpr int directionIndex(char direction) {
+    int d = DIRECTION_LOOKUP.index[(uint8_t)direction];
+    return d < DIRECTION_COUNT ? d : -1;
+}
+
+// A spare bit past the last cell, never set in an occupied mask
+static_assert(CELL_COUNT < Mask::WORDS * 64, "the off-board marker needs a bit past the last cell");
+
+constexpr Mask buildOffBoard() {
+    Mask m = {};
+    m.setBit(CELL_COUNT);
+    return m;
+}
+
+inline constexpr Mask OFF_BOARD = buildOffBoard();
+
+// One legal spot for a ship on the empty default board
+struct Placement {
+    Mask cells;
+    int8_t x, y;
+    char direction;
+};
+
+// Every placement of every ship length on the empty 10x10 board
+struct PlacementTable {
+    Mask masks[MAX_SHIP_LENGTH + 1][DIRECTION_COUNT][CELL_COUNT];    // Empty mask where the ship leaves the board
+    Mask fits[MAX_SHIP_LENGTH + 1][DIRECTION_COUNT + 1][CELL_COUNT]; // Same, OFF_BOARD where there is no ship, the extra direction is a bad one
+    Placement legal[MAX_SHIP_LENGTH + 1][DIRECTION_COUNT * CELL_COUNT];
+    int legalCount[MAX_SHIP_LENGTH + 1];
+};
+
+constexpr PlacementTable buildPlacementTable() {
+    PlacementTable table = {};
+    for (int length = 0; length <= MAX_SHIP_LENGTH; ++length)
+    {
+        for (int d = 0; d <= DIRECTION_COUNT; ++d)
+        {
+            for (int cell = 0; cell < CELL_COUNT; ++cell) table.fits[length][d][cell] = OFF_BOARD;
+        }
+    }
+    for (int length = 1; length <= MAX_SHIP_LENGTH; ++length)
+    {
+        for (int d = 0; d < DIRECTION_COUNT; ++d)
+        {
+            for (int x = 0; x < GRID_SIZE; ++x)
+            {
+                for (int y = 0; y < GRID_SIZE; ++y)
+                {
+                    Mask cells = Grid::line(x, y, length, DIRECTIONS[d]);
+                    table.masks[length][d][x * GRID_SIZE + y] = cells;
+                    if (cells.any())
+                    {
+                        table.fits[length][d][x * GRID_SIZE + y] = cells;
+                        Placement& p = table.legal[length][table.legalCount[length]++];
+                        p.cells = cells;
+                        p.x = (int8_t)x;
+                        p.y = (int8_t)y;
+                        p.direction = DIRECTIONS[d];
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+// Built by the compiler, nothing is computed at startup
+inline constexpr PlacementTable PLACEMENTS = buildPlacementTable();
+
+// Cells of a ship at (x,y), empty if it leaves the board or the direction is invalid
+inline Mask placementMask(int x, int y, int length, char direction) {
+    int d = directionIndex(direction);
+    if (d < 0 || length < 1 || !Grid::inBounds(x, y)) return Mask();
+    if (length > MAX_SHIP_LENGTH) return Grid::line(x, y, length, direction); // Longer than any fleet uses, not tabled
+    return PLACEMENTS.masks[length][d][x * GRID_SIZE + y];
+}
+
+// Placement check as one AND against everything already on the board (ships and islands).
+// Any length up to MAX_SHIP_LENGTH and any direction char is tabled, so an origin on the
+// board takes a single well-predicted branch and the OFF_BOARD bit rejects the rest.
+inline bool fitsOn(const Mask& occupied, int x, int y, int length, char direction) {
+    if (((unsigned)x < (unsigned)GRID_SIZE) & ((unsigned)y < (unsigned)GRID_SIZE) & ((unsigned)length <= (unsigned)MAX_SHIP_LENGTH))
+    {
+        int d = DIRECTION_LOOKUP.index[(uint8_t)direction];
+        return (PLACEMENTS.fits[length][d][x * GRID_SIZE + y] & (occupied | OFF_BOARD)).none();
+    }
+    Mask cells = placementMask(x, y, length, direction);   // Off the board, or a ship longer than any fleet's
+    return cells.any() && (cells & occupied).none();
+}
+
+// Jenkins' 3x3 search area around every cell of the default board, clipped at the edges
+struct SquareTable {
+    Mask around[CELL_COUNT];
+};
+
+constexpr SquareTable buildSquareTable() {
+    SquareTable table = {};
+    for (int i = 0; i < CELL_COUNT; ++i) table.around[i] = Grid::square(i / GRID_SIZE, i % GRID_SIZE, 1);
+    return table;
+}
+
+inline constexpr SquareTable SQUARES = buildSquareTable();
+
+// Same as Grid::square(x, y, 1) as a table lookup, centers off the board are built on the spot
+inline Mask squareMask(int x, int y) {
+    if (!Grid::inBounds(x, y)) return Grid::square(x, y, 1);
+    return SQUARES.around[x * GRID_SIZE + y];
+}
+
+// Calls f(placement) for every spot where a ship of 'length' avoids the 'occupied' cells
+template<typename F>
+void forEachLegalPlacement(const Mask& occupied, int length, F f) {
+    const Placement* list = PLACEMENTS.legal[length];
+    for (int i = 0; i < PLACEMENTS.legalCount[length]; ++i)
+    {
+        if ((list[i].cells & occupied).none()) f(list[i]);
+    }
+}
+
+#endif
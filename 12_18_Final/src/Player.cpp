@@ -1,15 +1,42 @@
 #include "Player.hpp"
+#include <algorithm>
 #include "Game.hpp"
 #include "EventLogger.hpp"
+#include "Placement.hpp"
+#include "FleetGenerator.hpp"
+#include "Computer.hpp"
+#include "Zobrist.hpp"
 
 Player::Player(string name)
-    : name(name), grid(GRID_SIZE, vector<char>(GRID_SIZE, WATER)),
-      guessGrid(GRID_SIZE, vector<char>(GRID_SIZE, WATER)), usedPowerUp(false) {}
+    : name(name), grid(), guessGrid(), terrain(Terrain::openSeas()), usedPowerUp(false), shipCellsLeft(0), hash(0) {
+    shipAt.fill(-1);    // No ships placed yet
+}
 
 void Player::placeShips(Game& game) {
     // Prompt the player to place each ship
     cout << name << ", place your ships on the grid." << endl;
-    game.printGrid(grid);
+    game.printGrid(ownView());
+
+    char mode = ' ';
+    while (mode != 'm' && mode != 'a')
+    {
+        cout << "Enter 'm' to place your ships by hand or 'a' to have them placed at random: " << endl;
+        if (!(cin >> mode)) 
+        {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+    if (mode == 'a') 
+    {
+        if (autoPlaceShips(game)) 
+        {
+            game.printGrid(ownView());
+            return;
+        }
+        cout << "No room for the fleet, place it by hand." << endl;
+    }
+
     for (int i = 0; i < (int)shipLengths.size(); ++i) 
     {
         int length = shipLengths[i];
@@ -28,37 +55,12 @@ void Player::placeShips(Game& game) {
                 cout << "Invalid input. Please enter two integers and a character."<<endl;
             }
 
-            // Check if placement is valid using Game's method
-            if (game.isValidPlacement(*this, x, y, length, direction)) 
+            // The engine checks the placement and places the next ship of the fleet
+            if (game.engine.apply(Action::place(x, y, direction)).accepted) 
             {
                 event("placed ship", name, x, y, direction);
-                // Place ship based on direction
-                if (direction == 'h') // Horizontal Placement
-                {
-                    for (int j = 0; j < length; ++j) 
-                    {
-                        grid[x][y + j] = SHIP; // Placing to the right of the slected point
-                    }
-                } 
-                
-                else if (direction == 'v')  // Vertical Placement
-                {
-                    for (int j = 0; j < length; ++j) 
-                    {
-                        grid[x + j][y] = SHIP; // Placing below a certian point
-                    }
-                } 
-                
-                else if (direction == 'd')  // Diagonal Placement
-                {
-                    for (int j = 0; j < length; ++j) 
-                    {
-                        grid[x + j][y + j] = SHIP; //Using linear slope formula to place ship down and to the left of the code
-                    }
-                }
-                
                 shipPlaced = true;               // Ship successfully placed
-                game.printGrid(grid);            // Show updated grid
+                game.printGrid(ownView());       // Show updated grid
             } 
             
             else
@@ -69,23 +71,115 @@ void Player::placeShips(Game& game) {
     }
 }
 
-bool Player::allShipsSunk() const {
-    // Check grid for any 'S' cells left
-    for (const auto& row : grid) 
+bool Player::autoPlaceShips(Game& game) {
+    // Uniform over every complete legal layout on this map, drawn from the game's generator
+    vector<const Placement*> fleet;
+    if (!FleetGenerator(occupied(), shipLengths).sample(game.rng, fleet)) return false;
+
+    for (const Placement* p : fleet) 
     {
-        for (char cell : row) 
-        {
-            if (cell == SHIP) 
-            {
-                return false; // Found a ship cell, so not all sunk
-            }
-        }
+        game.engine.apply(Action::place(p->x, p->y, p->direction));
+        event("placed ship", name, p->x, p->y, p->direction);
+    }
+    return true;
+}
+
+bool Player::canPlaceShip(int x, int y, int length, char direction) const {
+    // One AND of the precomputed ship mask against ships and islands
+    return fitsOn(occupied(), x, y, length, direction);
+}
+
+void Player::addShip(int x, int y, int length, char direction) {
+    // Register the ship and tag each of its cells with its id
+    Ship ship = {(int)ships.size(), length, x, y, direction, 0};
+    Mask shipCells = placementMask(x, y, length, direction);
+    shipCells.forEach([&](int i, int j) {
+        shipAt[i * GRID_SIZE + j] = (int8_t)ship.id;
+    });
+    ships.push_back(ship);
+
+    addCells(grid.ships, shipCells, OWN_SHIP);  // Mark every cell of the ship at once
+    shipCellsLeft += length;
+}
+
+Grid Player::ownView() const {
+    Grid view = grid;
+    view.islands = terrain->islands;
+    return view;
+}
+
+uint64_t Player::computeHash() const {
+    return zobristOf(grid.ships, OWN_SHIP) ^ zobristOf(grid.hits, OWN_HIT) ^ zobristOf(grid.misses, OWN_MISS)
+         ^ zobristOf(guessGrid.hits, GUESS_HIT) ^ zobristOf(guessGrid.misses, GUESS_MISS);
+}
+
+void Player::redeployFleet(const vector<const Placement*>& fleet) {
+    // Cells already hit stay hits, the rest of each new position becomes live ship cells
+    removeCells(grid.ships, grid.ships, OWN_SHIP);
+    shipAt.fill(-1);
+    for (int i = 0; i < (int)ships.size(); ++i)
+    {
+        const Placement& placement = *fleet[i];
+        Ship& ship = ships[i];
+        ship.x = placement.x;
+        ship.y = placement.y;
+        ship.direction = placement.direction;
+        ship.hits = (placement.cells & grid.hits).count();
+        addCells(grid.ships, placement.cells.andNot(grid.hits), OWN_SHIP);
+        placement.cells.forEach([&](int x, int y) {
+            shipAt[x * GRID_SIZE + y] = (int8_t)i;
+        });
     }
+    shipCellsLeft = grid.ships.count();
+}
+
+void Player::save(PlayerSnapshot& snapshot) const {
+    snapshot.ships = grid.ships;
+    snapshot.hits = grid.hits;
+    snapshot.misses = grid.misses;
+    snapshot.guessHits = guessGrid.hits;
+    snapshot.guessMisses = guessGrid.misses;
+    snapshot.shipCount = (uint8_t)ships.size();
+    copy(ships.begin(), ships.end(), snapshot.fleet);
+    copy(shipAt.begin(), shipAt.end(), snapshot.shipAt);
+    snapshot.usedPowerUp = usedPowerUp;
+    snapshot.powerCounter = 0;
+    snapshot.shipCellsLeft = shipCellsLeft;
+    snapshot.hash = hash;
+}
+
+void Player::restore(const PlayerSnapshot& snapshot) {
+    grid.ships = snapshot.ships;
+    grid.hits = snapshot.hits;
+    grid.misses = snapshot.misses;
+    guessGrid.hits = snapshot.guessHits;
+    guessGrid.misses = snapshot.guessMisses;
+    ships.assign(snapshot.fleet, snapshot.fleet + snapshot.shipCount);
+    copy(snapshot.shipAt, snapshot.shipAt + CELL_COUNT, shipAt.begin());
+    usedPowerUp = snapshot.usedPowerUp;
+    shipCellsLeft = snapshot.shipCellsLeft;
+    hash = snapshot.hash;   // Saved with the cells, nothing to recompute
+}
+
+void Player::addCells(Mask& layerMask, const Mask& cells, int layer) {
+    // Only cells that actually change flip their key in the hash
+    Mask added = cells.andNot(layerMask);
+    layerMask |= added;
+    hash ^= zobristOf(added, layer);
+}
+
+void Player::removeCells(Mask& layerMask, const Mask& cells, int layer) {
+    Mask removed = cells & layerMask;
+    layerMask = layerMask.andNot(removed);
+    hash ^= zobristOf(removed, layer);
+}
 
-    return true; // No ship cells found
+bool Player::allShipsSunk() const {
+    // Counter is kept up to date by every hit, no board scan needed
+    return shipCellsLeft == 0;
 }
 
-bool Player::takeTurn(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) {
+bool Player::takeTurn(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) {
     // Prompt player for attack coordinates
     int x, y;
     event("chose attack", name);
@@ -94,167 +188,249 @@ bool Player::takeTurn(Game& game, Player& opponent, bool blitzMode, chrono::stea
     if (!game.timedInput(y, blitzMode, startTime)) return true; // If time up, end turn
 
     // Validate coordinates
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) 
+    if (!Grid::inBounds(x, y)) 
     {
         cout << "Invalid coordinates. Try again." << endl;
         return false; // Let them try again this turn
     }
 
-    // Check what is at that coordinate on the opponent's grid
-    if (opponent.grid[x][y] == SHIP) // You scored a hit
+    Player& opponent = game.engine.defender();
+    Result result = game.engine.apply(Action::attack(x, y));
+    if (!result.accepted) 
+    {
+        // Already attacked cell (HIT, MISS, or ISLAND)
+        cout << "You already attacked this position. Try again." << endl;
+        return false; // Must re-enter coordinates
+    }
+
+    if (result.hits.any()) // You scored a hit
     {
         cout << "It's a hit!" << endl;
-        opponent.grid[x][y] = HIT;
-        guessGrid[x][y] = HIT;
         event("successful hit", name, x, y);
-        return true; // Turn completes successfully
+        reportSunk(result, opponent);
     } 
     
-    else if (opponent.grid[x][y] == WATER)  // You missed the shot
+    else  // You missed the shot
     {
         cout << "You missed." << endl;
-        opponent.grid[x][y] = MISS;
-        guessGrid[x][y] = MISS;
         event("unsuccessful hit", name, x, y);
-        return true; // Turn completes with a miss
+    } 
+    return true; // Turn completes
+}
+
+bool Player::fire(Player& opponent, int x, int y, Result& result) {
+    if (!Grid::inBounds(x, y)) return false;
+
+    // Check what is at that coordinate on the opponent's grid
+    Mask target = Mask::cell(x, y);
+    if (opponent.grid.ships.test(x, y)) // Hit
+    {
+        result.hits = target;
+        result.sunkShips = recordHits(opponent, target);
+        return true;
     } 
     
-    else 
+    if (!opponent.occupied().test(x, y)) // Miss
     {
-        // Already attacked cell (HIT, MISS, or ISLAND)
-        cout << "You already attacked this position. Try again." << endl;
-        return false; // Must re-enter coordinates
+        opponent.addCells(opponent.grid.misses, target, OWN_MISS);
+        addCells(guessGrid.misses, target, GUESS_MISS);
+        result.misses = target;
+        return true;
+    } 
+
+    return false; // Already attacked cell (HIT, MISS, or ISLAND)
+}
+
+void Player::revealArea(Player& opponent, const Mask& area, Result& result) {
+    // Ships inside the area become hits, open water is marked as a miss on the guess grid,
+    // islands are taken out of the area first since they are neither
+    Grid::Reveal found = opponent.grid.reveal(area.andNot(opponent.terrain->islands));
+    addCells(guessGrid.misses, found.misses, GUESS_MISS);
+    result.hits = found.hits;
+    result.misses = found.misses;
+    result.sunkShips = recordHits(opponent, found.hits);
+}
+
+uint8_t Player::recordHits(Player& opponent, const Mask& hitCells) {
+    // Move the cells from the opponent's ship layer to the hit layer
+    opponent.removeCells(opponent.grid.ships, hitCells, OWN_SHIP);
+    opponent.addCells(opponent.grid.hits, hitCells, OWN_HIT);
+    opponent.shipCellsLeft -= hitCells.count();
+    addCells(guessGrid.hits, hitCells, GUESS_HIT);
+
+    // Credit each hit to the ship that owns the cell and note any that went down
+    uint8_t sunk = 0;
+    hitCells.forEach([&](int i, int j) {
+        Ship& ship = opponent.ships[opponent.shipAt[i * GRID_SIZE + j]];
+        ship.hits++;
+        if (ship.sunk()) sunk |= (uint8_t)(1 << ship.id);
+    });
+    return sunk;
+}
+
+void Player::reportSunk(const Result& result, const Player& opponent) {
+    for (const Ship& ship : opponent.ships) 
+    {
+        if (result.sunkShips & (1 << ship.id)) 
+        {
+            cout << "You sunk " << opponent.name << "'s ship of length " << ship.length << "!" << endl;
+            event("sunk a ship", name, ship.x, ship.y, ship.direction);
+        }
     }
 }
 
+void Player::reportReveal(const Result& result, const Player& opponent) {
+    // Report in row-major order
+    (result.hits | result.misses).forEach([&](int i, int j) {
+        if (result.hits.test(i, j))
+        {
+            cout << "Hit found at (" << i << ", " << j << ")!" << endl;
+        }
+        else
+        {
+            cout << "Miss at (" << i << ", " << j << ")" << endl;
+        }
+    });
+    reportSunk(result, opponent);
+}
+
+Player* createCaptain(int choice, bool computer) {
+    Player* player = nullptr;
+    if (choice == 1)  // Pick Jenkins
+    {
+        player = computer ? new Computer<Jenkins>() : new Jenkins(); // Assigns current player to have the jenkins class
+        player->shipLengths = {1, 2, 3, 4, 5};   // Assigns the current player jenkins fleet
+    } 
+    
+    else if (choice == 2) // Pick Ironsides
+    {
+        player = computer ? new Computer<Ironsides>() : new Ironsides(); // Assigns current player to have the ironsides class
+        player->shipLengths = {2, 2, 2, 4, 5};   // Assigns the current player ironsides fleet
+    } 
+    
+    else if (choice == 3) 
+    {
+        player = computer ? new Computer<Steven>() : new Steven();   // Pick Steven
+        player->shipLengths = {3, 3, 3, 3, 3};   // Assigns the current player steven fleet
+    } 
+    return player;
+}
+
 Jenkins::Jenkins() : Player("Jenkins") {}
 
-bool Jenkins::usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) {
+bool Jenkins::usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) {
     if (usedPowerUp) 
     {
         cout << name << ", you have already used your power-up." << endl;
         return false; // Can't use power-up twice
     }
 
-    usedPowerUp = true;
     cout << name << " is using their power-up!" << endl;
     event("using power-up radius search", name);
 
     int x, y;
     cout << "Enter the center coordinates to search in a 1 radius area (row and column): " << endl;
     event("searching in a 1 radius area", name);
-    if (!game.timedInput(x, blitzMode, startTime)) return true; // If time out, turn ends
-    if (!game.timedInput(y, blitzMode, startTime)) return true; // If time out, turn ends
-
-    // Check a 3x3 block centered at (x,y)
-    
-    for (int i = -1; i <= 1; ++i) 
+    if (!game.timedInput(x, blitzMode, startTime) || !game.timedInput(y, blitzMode, startTime))
     {
-        for (int j = -1; j <= 1; ++j) 
-        {
-            int newX = x + i;
-            int newY = y + j;
-            
-            if (newX >= 0 && newX < GRID_SIZE && newY >= 0 && newY < GRID_SIZE) 
-            {
-                if (opponent.grid[newX][newY] == SHIP) 
-                {
-                    cout << "Hit found at (" << newX << ", " << newY << ")!" << endl;
-                    opponent.grid[newX][newY] = HIT;
-                    guessGrid[newX][newY] = HIT;
-                } 
-                
-                else if (opponent.grid[newX][newY] == WATER) 
-                {
-                    cout << "Miss at (" << newX << ", " << newY << ")" << endl;
-                    guessGrid[newX][newY] = MISS;
-                }
-            }
-        }
+        usedPowerUp = true;     // Timing out still spends the power-up, the turn ends
+        return true;
     }
+
+    Player& opponent = game.engine.defender();
+    Result result = game.engine.apply(Action::powerUp(x, y));
+    reportReveal(result, opponent);
     return true; // Power-up used
 }
 
+bool Jenkins::powerUp(Player& opponent, const Action& action, Result& result) {
+    if (usedPowerUp) return false; // Can't use power-up twice
+    usedPowerUp = true;
+
+    // Check a 3x3 block centered at (x,y), clipped to the board
+    revealArea(opponent, squareMask(action.x, action.y), result);
+    return true;
+}
+
 Ironsides::Ironsides() : Player("Ironsides") {}
 
-bool Ironsides::usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) {
+bool Ironsides::usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) {
     if (usedPowerUp) 
     {
         cout << name << ", you have already used your power-up." << endl;
         return false;
     }
 
-    usedPowerUp = true;
     cout << name << " is using their power-up!" << endl;
     event("using power-up row or colum search");
 
     char choice;
     int index;
     cout << "Enter 'r' to search an entire row or 'c' to search an entire column: " << endl; // Allows the player to choose between attacking a row or column
-    if (!game.timedInput(choice, blitzMode, startTime)) return true;
-    cout << "Enter the index of the row or column to search (0 to " << GRID_SIZE - 1 << "): " << endl;
-    if (!game.timedInput(index, blitzMode, startTime)) return true;
+    bool answered = game.timedInput(choice, blitzMode, startTime);
+    if (answered)
+    {
+        cout << "Enter the index of the row or column to search (0 to " << GRID_SIZE - 1 << "): " << endl;
+        answered = game.timedInput(index, blitzMode, startTime);
+    }
+    if (!answered)
+    {
+        usedPowerUp = true;     // Timing out still spends the power-up, the turn ends
+        return true;
+    }
 
-    // Perform row scan
-    if (choice == 'r' && index >= 0 && index < GRID_SIZE) 
+    Player& opponent = game.engine.defender();
+    Result result = game.engine.apply(choice == 'c' ? Action::powerUp(0, index, 'c') : Action::powerUp(index, 0, choice));
+    if (!result.accepted) 
     {
-        for (int j = 0; j < GRID_SIZE; ++j) 
-        {
-            if (opponent.grid[index][j] == SHIP) 
-            {
-                cout << "Hit found at (" << index << ", " << j << ")!" << endl;
-                opponent.grid[index][j] = HIT;
-                guessGrid[index][j] = HIT;
-            } 
-            
-            else if (opponent.grid[index][j] == WATER) 
-            {
-                cout << "Miss at (" << index << ", " << j << ")" << endl;
-                guessGrid[index][j] = MISS;
-            }
-        }
+        // Invalid choice or index
+        cout << "Invalid choice or index." << endl; // Let user try again another turn
+        return false;
+    }
+
+    reportReveal(result, opponent);
+    return true; // Power-up used
+}
+
+bool Ironsides::powerUp(Player& opponent, const Action& action, Result& result) {
+    if (usedPowerUp) return false;
+
+    if (action.mode == 'r' && action.x >= 0 && action.x < GRID_SIZE) 
+    {
+        revealArea(opponent, Grid::row(action.x), result);          // Perform row scan
     } 
-    
-    // Perform column scan
-    else if (choice == 'c' && index >= 0 && index < GRID_SIZE) 
+    else if (action.mode == 'c' && action.y >= 0 && action.y < GRID_SIZE) 
     {
-        for (int i = 0; i < GRID_SIZE; ++i) 
-        {
-            if (opponent.grid[i][index] == SHIP) 
-            {
-                cout << "Hit found at (" << i << ", " << index << ")!" << endl;
-                opponent.grid[i][index] = HIT;
-                guessGrid[i][index] = HIT;
-            } 
-            
-            else if (opponent.grid[i][index] == WATER)
-            {
-                cout << "Miss at (" << i << ", " << index << ")" << endl;
-                guessGrid[i][index] = MISS;
-            }
-        }
+        revealArea(opponent, Grid::column(action.y), result);       // Perform column scan
     } 
-    
     else 
     {
-        // Invalid choice or index
-        cout << "Invalid choice or index." << endl;
-        usedPowerUp = false; // Let user try again another turn
-        return false;
+        return false; // Invalid choice or index, power-up stays available
     }
-    
-    return true; // Power-up used
+
+    usedPowerUp = true;
+    return true;
 }
 
 Steven::Steven() : Player("Steven"), powercounter(1) {}
 
-bool Steven::usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) {
+void Steven::save(PlayerSnapshot& snapshot) const {
+    Player::save(snapshot);
+    snapshot.powerCounter = powercounter;
+}
+
+void Steven::restore(const PlayerSnapshot& snapshot) {
+    Player::restore(snapshot);
+    powercounter = snapshot.powerCounter;
+}
+
+bool Steven::usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) {
     if (powercounter > 3) 
     {
         usedPowerUp = true; // If used more than three times do not allow to be used again
     }
 
-    if (usedPowerUp) 
+    if (usedPowerUp || !game.engine.apply(Action::powerUp()).accepted) 
     {
         cout << name << ", you have already used your power-up." << endl; // Indicating that the power up is completely used up
         return false;
@@ -262,13 +438,31 @@ bool Steven::usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::st
 
     event("using power-up 3 attacks", name);
     cout << name << " is using their power-up!" << endl;
-    cout << "Three attacks remaining" << endl;
-    takeTurn(game, opponent, blitzMode, startTime); // 1st attack
-    cout << "Two attacks remaining" << endl;
-    takeTurn(game, opponent, blitzMode, startTime); // 2nd attack
-    cout << "One attack remaining" << endl;
-    takeTurn(game, opponent, blitzMode, startTime); // 3rd attack
-    cout << "You can use this powerup " << 3 - powercounter << " more times." << endl;
-    powercounter++; // Updating the number of times the power has been used.
+
+    // One prompt per bonus attack: an off-board or repeated cell loses that attack
+    const char* remaining[] = {"", "One attack remaining", "Two attacks remaining", "Three attacks remaining"};
+    while (game.engine.state.bonusAttacks > 0) 
+    {
+        int attacksLeft = game.engine.state.bonusAttacks;
+        cout << remaining[attacksLeft] << endl;
+        if (!takeTurn(game, blitzMode, startTime)) 
+        {
+            game.engine.apply(Action::forfeit());
+        }
+        else if (game.engine.state.bonusAttacks == attacksLeft) 
+        {
+            break; // Timed out, Game::start passes the turn
+        }
+    }
+    cout << "You can use this powerup " << 4 - powercounter << " more times." << endl;
     return true; // Power-up used
 }
+
+bool Steven::powerUp(Player&, const Action&, Result& result) {
+    if (powercounter > 3) usedPowerUp = true; // Only three triple shots per match
+    if (usedPowerUp) return false;
+
+    powercounter++; // Updating the number of times the power has been used.
+    result.bonusAttacks = 3;
+    return true;
+}
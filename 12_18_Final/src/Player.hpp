@@ -3,48 +3,98 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <chrono>
+#include "Board.hpp"
+#include "Terrain.hpp"
+#include "Action.hpp"
 #include "Game.hpp"
 #include "EventLogger.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 
 class Game; // Forward declaration
+struct Placement;
 
 class Player {
 public:
     string name;
-    vector<vector<char>> grid;
-    vector<vector<char>> guessGrid;
+    Grid grid;          // Own ships and incoming hits/misses, islands live in 'terrain'
+    Grid guessGrid;     // What this player has learned about the opponent
+    TerrainPtr terrain; // Map shared with the opponent
     vector<int> shipLengths;
     bool usedPowerUp;
+    int shipCellsLeft;  // Ship cells not yet hit, kept live so the win check is one comparison
+    vector<Ship> ships;                 // Fleet in placement order, index is the ship id
+    array<int8_t, CELL_COUNT> shipAt;   // Ship id covering each cell, -1 for none
+    uint64_t hash;                      // Zobrist hash of grid and guessGrid, updated on every change
 
     Player(string name);
     virtual ~Player() = default;
+    virtual Player* clone() const = 0;  // Independent copy of the whole player, for what-if playouts
+
+    // Console frontend, every rule goes through game.engine
+    virtual void placeShips(Game& game);
+    bool autoPlaceShips(Game& game);    // Random fleet, false if the map leaves no room for one
+    virtual bool isComputer() const { return false; }
+    virtual void playTurn(Game&) {}         // A computer player picks and plays its whole turn here
+    bool takeTurn(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime);
+    virtual bool usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) = 0;
+
+    // Rules only, no console I/O, called by GameEngine
+    bool canPlaceShip(int x, int y, int length, char direction) const;
+    bool fleetPlaced() const { return ships.size() == shipLengths.size(); }
+    void addShip(int x, int y, int length, char direction); // Record a validated placement
+    bool fire(Player& opponent, int x, int y, Result& result);  // False if the cell can't be attacked
+    virtual bool powerUp(Player& opponent, const Action& action, Result& result) = 0;
 
-    void placeShips(Game& game);
     bool allShipsSunk() const;
-    virtual bool usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) = 0;
-    bool takeTurn(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime);
+    Mask occupied() const { return grid.occupied() | terrain->islands; } // Anything that is not open water
+    Grid ownView() const;                   // Own grid with the islands filled in, for printing
+    uint64_t computeHash() const;           // Full recompute, the live 'hash' should always match it
+    void redeployFleet(const vector<const Placement*>& fleet); // Move every ship (by id) keeping the hits taken so far
+    virtual void save(PlayerSnapshot& snapshot) const;      // Copy the match state out, no allocation
+    virtual void restore(const PlayerSnapshot& snapshot);   // Put it back, the ship list reuses its storage
+
+protected:
+    void revealArea(Player& opponent, const Mask& area, Result& result); // Power-up scan of every cell in 'area'
+    uint8_t recordHits(Player& opponent, const Mask& hitCells); // Apply hits to the opponent's fleet, returns sunk ship bits
+    void addCells(Mask& layerMask, const Mask& cells, int layer);    // Set cells on one of this player's layers
+    void removeCells(Mask& layerMask, const Mask& cells, int layer); // Clear cells on one of this player's layers
+    void reportSunk(const Result& result, const Player& opponent);   // Print and log the ships an action sank
+    void reportReveal(const Result& result, const Player& opponent); // Print a power-up's hits and misses
 };
 
 class Jenkins : public Player {
 public:
     Jenkins();
-    bool usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) override;
+    Player* clone() const override { return new Jenkins(*this); }
+    bool usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) override;
+    bool powerUp(Player& opponent, const Action& action, Result& result) override;
 };
 
 class Ironsides : public Player {
 public:
     Ironsides();
-    bool usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) override;
+    Player* clone() const override { return new Ironsides(*this); }
+    bool usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) override;
+    bool powerUp(Player& opponent, const Action& action, Result& result) override;
 };
 
 class Steven : public Player {
 public:
     Steven();
     int powercounter;
-    bool usePowerUp(Game& game, Player& opponent, bool blitzMode, chrono::steady_clock::time_point startTime) override;
+    Player* clone() const override { return new Steven(*this); }
+    void save(PlayerSnapshot& snapshot) const override;
+    void restore(const PlayerSnapshot& snapshot) override;
+    bool usePowerUp(Game& game, bool blitzMode, chrono::steady_clock::time_point startTime) override;
+    bool powerUp(Player& opponent, const Action& action, Result& result) override;
 };
 
+// Builds captain 1 (Jenkins), 2 (Ironsides) or 3 (Steven) with their fleet, null for anything else.
+// With 'computer' set the captain is played by the computer (see Computer.hpp).
+Player* createCaptain(int choice, bool computer = false);
+
 #endif
@@ -0,0 +1,59 @@
+#include "PowerUpPlanner.hpp"
+
+// Sum over rows [top, bottom) and columns [left, right) of a summed-area table
+static double rectangle(const double table[GRID_SIZE + 1][GRID_SIZE + 1], int top, int left, int bottom, int right) {
+    return table[bottom][right] - table[top][right] - table[bottom][left] + table[top][left];
+}
+
+PowerUpPlan planPowerUps(const DensityMap& density, const Mask& open) {
+    double expected[CELL_COUNT];
+    density.occupancy(open, expected);
+
+    // table[x][y] holds the sum over every cell above and left of (x, y)
+    double table[GRID_SIZE + 1][GRID_SIZE + 1] = {};
+    for (int x = 0; x < GRID_SIZE; ++x)
+    {
+        double rowSum = 0.0;
+        for (int y = 0; y < GRID_SIZE; ++y)
+        {
+            rowSum += expected[x * GRID_SIZE + y];
+            table[x + 1][y + 1] = table[x][y + 1] + rowSum;
+        }
+    }
+
+    PowerUpPlan plan;
+    for (int x = 0; x < GRID_SIZE; ++x)
+    {
+        int top = x > 0 ? x - 1 : 0;
+        int bottom = x + 2 < GRID_SIZE ? x + 2 : GRID_SIZE;
+        for (int y = 0; y < GRID_SIZE; ++y)
+        {
+            int left = y > 0 ? y - 1 : 0;
+            int right = y + 2 < GRID_SIZE ? y + 2 : GRID_SIZE;
+            plan.center[x * GRID_SIZE + y] = rectangle(table, top, left, bottom, right);
+        }
+        plan.row[x] = rectangle(table, x, 0, x + 1, GRID_SIZE);
+        plan.column[x] = rectangle(table, 0, x, GRID_SIZE, x + 1);
+    }
+    return plan;
+}
+
+int PowerUpPlan::bestCenter() const {
+    int best = 0;
+    for (int cell = 1; cell < CELL_COUNT; ++cell)
+    {
+        if (center[cell] > center[best]) best = cell;
+    }
+    return best;
+}
+
+int PowerUpPlan::bestLine() const {
+    int best = 0;
+    for (int line = 1; line < 2 * GRID_SIZE; ++line)
+    {
+        double score = line < GRID_SIZE ? row[line] : column[line - GRID_SIZE];
+        double bestScore = best < GRID_SIZE ? row[best] : column[best - GRID_SIZE];
+        if (score > bestScore) best = line;
+    }
+    return best;
+}
@@ -0,0 +1,24 @@
+#ifndef POWERUPPLANNER_HPP
+#define POWERUPPLANNER_HPP
+
+#include "Board.hpp"
+#include "DensityMap.hpp"
+
+using namespace std;
+
+// Expected hits of every Jenkins 3x3 center and every Ironsides row and column
+struct PowerUpPlan {
+    double center[CELL_COUNT];  // Jenkins block around each cell, clipped at the edges
+    double row[GRID_SIZE];
+    double column[GRID_SIZE];
+
+    int bestCenter() const;     // Cell index
+    int bestLine() const;       // Row index, or GRID_SIZE + column index for a column
+};
+
+// Scores all 120 targets from one summed-area table over the expected ship
+// cells: each target is a rectangle, so each score is four table lookups.
+// Only 'open' cells count, anything already shot at or revealed scores 0.
+PowerUpPlan planPowerUps(const DensityMap& density, const Mask& open);
+
+#endif
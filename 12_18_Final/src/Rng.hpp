@@ -0,0 +1,61 @@
+#ifndef RNG_HPP
+#define RNG_HPP
+
+#include <cstdint>
+
+using namespace std;
+
+// SplitMix64 step, used to expand one seed into well-mixed state words
+constexpr uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** generator. Every game owns one, so a game is reproduced from its
+// seed alone no matter how many other games run beside it.
+class Rng {
+public:
+    typedef uint64_t result_type;  // Usable wherever the standard library wants a URBG
+
+    explicit Rng(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        uint64_t state = seed;
+        for (int i = 0; i < 4; ++i) s[i] = splitMix64(state);
+    }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound), bound > 0. Multiply-shift instead of %, bias is below 2^-32 for board sized bounds
+    uint32_t below(uint32_t bound) { return (uint32_t)(((*this)() >> 32) * bound >> 32); }
+
+    // Independent child stream; the parent moves on, so repeated splits never share a stream
+    Rng split() {
+        Rng child;
+        uint64_t state = (*this)();
+        for (int i = 0; i < 4; ++i) child.s[i] = splitMix64(state) ^ (*this)();
+        return child;
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~0ULL; }
+
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif
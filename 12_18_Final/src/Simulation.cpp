@@ -0,0 +1,94 @@
+#include "Simulation.hpp"
+#include "Player.hpp"
+
+MatchRunner::MatchRunner(const MatchConfig& config)
+    : config(config), rng(), openSeas(make_shared<const Terrain>(Mask())) {
+    for (int side = 0; side < 2; ++side)
+    {
+        strategies[side] = makeStrategy(config.strategies[side], strategyRng[side]);
+        players[side].reset(createCaptain(config.captains[side]));
+        if (!players[side]) continue;
+        players[side]->terrain = openSeas;
+        players[side]->save(fresh[side]);
+    }
+}
+
+MatchRunner::~MatchRunner() = default;
+
+MatchRecord MatchRunner::play(uint64_t seed, PackedBoard* finalBoards) {
+    rng.seed(seed);
+    strategyRng[0] = rng.split();
+    strategyRng[1] = rng.split();
+    MatchRecord record = {-1, 0};
+
+    TerrainPtr terrain = openSeas;
+    if (config.shatteredSea)
+    {
+        terrain = make_shared<const Terrain>(Terrain::scatterIslands(rng));
+    }
+
+    GameEngine engine;
+    for (int side = 0; side < 2; ++side)
+    {
+        players[side]->restore(fresh[side]);
+        players[side]->terrain = terrain;
+        strategies[side]->reset();
+    }
+    engine.begin(players[0].get(), players[1].get());
+
+    // Both fleets go down at random, the engine switches placer after the first
+    placeFleetRandomly(engine, rng, fleetGenerators[0]);
+    placeFleetRandomly(engine, rng, fleetGenerators[1]);
+
+    while (engine.state.phase == Phase::Battle && engine.state.turn < config.maxTurns)
+    {
+        Strategy& strategy = *strategies[engine.state.current];
+        Action action = strategy.chooseAction(engine);
+        Result result = engine.apply(action);
+        if (!result.accepted)
+        {
+            engine.apply(Action::endTurn()); // A strategy bug must not stall the batch
+            continue;
+        }
+        strategy.observe(engine, action, result);
+    }
+
+    record.winner = engine.state.winner;
+    record.turns = engine.state.turn;
+    for (int side = 0; finalBoards && side < 2; ++side)
+    {
+        finalBoards[2 * side] = PackedBoard::pack(players[side]->grid);
+        finalBoards[2 * side + 1] = PackedBoard::pack(players[side]->guessGrid); // Shots and power-up reveals alike
+    }
+    return record;
+}
+
+void placeFleetRandomly(GameEngine& engine, Rng& rng, FleetGenerator& generator) {
+    Player& player = engine.attacker();
+    vector<int> remaining(player.shipLengths.begin() + player.ships.size(), player.shipLengths.end());
+    vector<const Placement*> fleet;
+    generator.reset(player.occupied(), remaining);
+    if (!generator.sample(rng, fleet)) return; // Boxed in by islands
+
+    for (const Placement* chosen : fleet)
+    {
+        engine.apply(Action::place(chosen->x, chosen->y, chosen->direction));
+    }
+}
+
+uint64_t gameSeed(uint64_t baseSeed, uint64_t gameIndex) {
+    uint64_t state = baseSeed ^ (gameIndex * 0xD1B54A32D192ED03ULL);
+    return splitMix64(state);
+}
+
+int captainFromName(const string& name) {
+    if (name == "jenkins") return 1;
+    if (name == "ironsides") return 2;
+    if (name == "steven") return 3;
+    return 0;
+}
+
+const char* captainName(int captain) {
+    const char* names[] = {"?", "Jenkins", "Ironsides", "Steven"};
+    return captain >= 1 && captain <= 3 ? names[captain] : names[0];
+}
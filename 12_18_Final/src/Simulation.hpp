@@ -0,0 +1,90 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Engine.hpp"
+#include "FleetGenerator.hpp"
+#include "PackedBoard.hpp"
+#include "Rng.hpp"
+#include "Snapshot.hpp"
+#include "Strategy.hpp"
+#include "Terrain.hpp"
+
+using namespace std;
+
+// Who plays whom, on which map, with which automated strategies
+struct MatchConfig {
+    int captains[2];        // 1 Jenkins, 2 Ironsides, 3 Steven (same numbering as selectCaptain)
+    bool shatteredSea;      // Random islands instead of the Open Seas
+    string strategies[2];
+    int maxTurns;           // Safety cap, a game past it counts as a draw
+};
+
+// Boards MatchRunner::play hands back per game: player 1's own grid and guess grid, then player 2's
+const int FINAL_BOARDS = 4;
+
+struct MatchRecord {
+    int winner;             // 0 or 1, -1 for a draw
+    int turns;
+};
+
+// Totals over many games, cheap to merge across threads
+struct BatchStats {
+    long long games;
+    long long wins[2];
+    long long draws;
+    long long turns;
+
+    void add(const MatchRecord& record) {
+        games++;
+        turns += record.turns;
+        if (record.winner >= 0) wins[record.winner]++;
+        else draws++;
+    }
+
+    void merge(const BatchStats& other) {
+        games += other.games;
+        wins[0] += other.wins[0];
+        wins[1] += other.wins[1];
+        draws += other.draws;
+        turns += other.turns;
+    }
+};
+
+// Plays complete automated games for one config. Each runner owns its RNG,
+// strategies, players and Open Seas terrain, reused from game to game, so one
+// runner per thread shares nothing with the others, not even a reference count. The map
+// and fleets come from the game's main stream, each strategy gets a split-off
+// stream of its own, so changing one strategy never shifts the other's draws.
+class MatchRunner {
+public:
+    explicit MatchRunner(const MatchConfig& config);
+    ~MatchRunner();                       // Out of line, Player is only declared here
+    bool isValid() const { return strategies[0] && strategies[1] && players[0] && players[1]; }
+    MatchRecord play(uint64_t seed, PackedBoard* finalBoards = nullptr);  // Fills FINAL_BOARDS boards when given
+
+private:
+    MatchConfig config;
+    Rng rng;
+    Rng strategyRng[2];
+    unique_ptr<Strategy> strategies[2];
+    FleetGenerator fleetGenerators[2];    // One per side so the Open Seas lists are built once
+    TerrainPtr openSeas;                  // This runner's own copy, Terrain::openSeas() is shared by every thread
+    unique_ptr<Player> players[2];
+    PlayerSnapshot fresh[2];              // Each player before placement, restored at the start of a game
+};
+
+// Places the rest of the fleet of the player the engine is waiting on,
+// uniformly over every complete legal layout. Reusing 'generator' for the same
+// map and captain skips rebuilding its spot lists
+void placeFleetRandomly(GameEngine& engine, Rng& rng, FleetGenerator& generator);
+
+// Spreads a run-wide seed into independent per-game seeds
+uint64_t gameSeed(uint64_t baseSeed, uint64_t gameIndex);
+
+int captainFromName(const string& name);   // "jenkins" -> 1 etc., 0 if unknown
+const char* captainName(int captain);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include "Board.hpp"
+#include "Engine.hpp"
+
+using namespace std;
+
+// Result::sunkShips has one bit per ship, so no fleet is ever bigger than this
+const int MAX_SHIPS = 8;
+
+// One placed ship, hit count goes up as the opponent finds its cells
+struct Ship {
+    int id;
+    int length;
+    int x, y;           // Starting cell
+    char direction;     // h/v/d as entered at placement
+    int hits;
+
+    bool sunk() const { return hits >= length; }
+};
+
+// Everything a Player carries that changes during a match. Name, fleet lengths
+// and terrain are fixed once the captain is picked, so they are left out.
+struct PlayerSnapshot {
+    Mask ships, hits, misses;       // Own grid
+    Mask guessHits, guessMisses;    // guessGrid
+    Ship fleet[MAX_SHIPS];          // First shipCount entries are used
+    int8_t shipAt[CELL_COUNT];
+    uint8_t shipCount;
+    bool usedPowerUp;
+    int powerCounter;               // Steven's powercounter, 0 for the others
+    int shipCellsLeft;
+    uint64_t hash;
+};
+
+// A whole match in one flat block: copy it with memcpy or plain assignment,
+// hand it to GameEngine::restore to jump back to it
+struct GameSnapshot {
+    Mask islands;
+    PlayerSnapshot players[2];
+    int current;
+    Phase phase;
+    int turn;
+    int bonusAttacks;
+    int winner;
+};
+
+static_assert(is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must stay memcpy-able");
+
+#endif
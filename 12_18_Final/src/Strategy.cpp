@@ -0,0 +1,224 @@
+#include "Strategy.hpp"
+#include <cmath>
+#include <cstdlib>
+#include "Player.hpp"
+#include "Mcts.hpp"
+#include "OpeningBook.hpp"
+
+Mask unexploredCells(const Player& player) {
+    return Mask::all().andNot(player.guessGrid.hits | player.guessGrid.misses | player.terrain->islands);
+}
+
+Action RandomStrategy::chooseAction(const GameEngine& engine) {
+    Mask open = unexploredCells(engine.attacker());
+    int index = open.nthSetBit((int)rng.below((uint32_t)open.count()));
+    return Action::attack(index / GRID_SIZE, index % GRID_SIZE);
+}
+
+Action PlayoutStrategy::chooseAction(const GameEngine& engine) {
+    const Player& self = engine.attacker();
+    if (self.usedPowerUp || engine.state.bonusAttacks > 0 || rng.below(POWER_UP_ODDS) != 0)
+    {
+        return fire.chooseAction(engine);
+    }
+
+    // Jenkins scans around (x, y), Ironsides takes row x or column y, Steven ignores both
+    int x = (int)rng.below(GRID_SIZE);
+    int y = (int)rng.below(GRID_SIZE);
+    return Action::powerUp(x, y, rng.below(2) ? 'r' : 'c');
+}
+
+Action DensityStrategy::chooseAction(const GameEngine& engine) {
+    const Player& self = engine.attacker();
+    if (!ready)
+    {
+        density.reset(self.terrain->islands, engine.defender().shipLengths);
+        ready = true;
+    }
+    int cell = OpeningBook::shared().nextShot(self, engine.defender().shipLengths);
+    if (cell < 0) cell = density.bestCell(unexploredCells(self), rng);
+    return Action::attack(cell / GRID_SIZE, cell % GRID_SIZE);
+}
+
+Action ParityStrategy::chooseAction(const GameEngine& engine) {
+    if (!ready) start(engine);
+    Mask open = unexploredCells(engine.attacker());
+
+    // Target: most recent lead first, stale entries are skipped
+    while (stackSize > 0)
+    {
+        int cell = stack[--stackSize];
+        if (open.test(cell / GRID_SIZE, cell % GRID_SIZE)) return Action::attack(cell / GRID_SIZE, cell % GRID_SIZE);
+    }
+
+    // Hunt: next open lattice cell in this game's order. Walking a shuffled list
+    // gives the same spread as a fresh random draw each time, at a bit test per cell.
+    Mask candidates = open & lattice;
+    for (; cursor < CELL_COUNT; ++cursor)
+    {
+        int cell = order[cursor];
+        if (candidates.test(cell / GRID_SIZE, cell % GRID_SIZE)) return Action::attack(cell / GRID_SIZE, cell % GRID_SIZE);
+    }
+
+    // Lattice used up (the misses were unlucky), any open cell will do
+    int index = open.nthSetBit((int)rng.below((uint32_t)open.count()));
+    return Action::attack(index / GRID_SIZE, index % GRID_SIZE);
+}
+
+void ParityStrategy::observe(const GameEngine& engine, const Action& action, const Result& result) {
+    if (!result.accepted) return;
+    hits |= result.hits;
+    result.hits.forEach([&](int x, int y) {
+        openHits++;
+        aimAround(x, y);
+    });
+
+    if (!result.sunkShips) return;
+    for (int id = 0; id < fleetSize; ++id)
+    {
+        if (!(result.sunkShips & (1 << id))) continue;
+        floating[fleet[id]]--;
+        openHits -= fleet[id];
+    }
+    if (openHits <= 0)
+    {
+        openHits = 0;       // Every hit belongs to a sunk ship, back to hunting
+        stackSize = 0;
+    }
+    updateLattice();
+}
+
+Mask ParityStrategy::huntLattice(int shortest, int phase) {
+    // Along h and v, (x + y) steps by 1, along d by 2. With an odd period m every run
+    // of m cells covers all residues, so a ship of m or more can't avoid one residue.
+    // Length 2 needs two residues out of three: no two neighbours share the third one.
+    Mask lattice = {};
+    if (shortest <= 1) return Mask::all();
+    int period = shortest == 2 ? 3 : shortest % 2 ? shortest : shortest - 1;
+    for (int x = 0; x < GRID_SIZE; ++x)
+    {
+        for (int y = 0; y < GRID_SIZE; ++y)
+        {
+            int residue = (x + y) % period;
+            bool kept = shortest == 2 ? residue != phase % period : residue == phase % period;
+            if (kept) lattice.setBit(x * GRID_SIZE + y);
+        }
+    }
+    return lattice;
+}
+
+void ParityStrategy::start(const GameEngine& engine) {
+    const Player& opponent = engine.defender();
+    const vector<int>& lengths = opponent.shipLengths;
+    fleetSize = 0;
+    for (int length = 0; length <= MAX_SHIP_LENGTH; ++length) floating[length] = 0;
+    for (int length : lengths)
+    {
+        if (fleetSize == MAX_SHIPS) break;
+        fleet[fleetSize++] = length;
+        if (length <= MAX_SHIP_LENGTH) floating[length]++;
+    }
+    phase = (int)rng.below(60);     // Divisible by every period, so each residue is equally likely
+    for (int i = 0; i < CELL_COUNT; ++i) order[i] = (uint8_t)i;
+    for (int i = CELL_COUNT - 1; i > 0; --i)
+    {
+        int j = (int)rng.below((uint32_t)(i + 1));
+        uint8_t swapped = order[i];
+        order[i] = order[j];
+        order[j] = swapped;
+    }
+    stackSize = 0;
+    lattice = Mask();
+    ready = true;
+
+    // Joining a game in progress (e.g. a search rollout): sunk ships are public,
+    // and every hit they don't account for gets its neighbours queued
+    hits = engine.attacker().guessGrid.hits;
+    openHits = hits.count();
+    for (const Ship& ship : opponent.ships)
+    {
+        if (!ship.sunk()) continue;
+        if (ship.length <= MAX_SHIP_LENGTH) floating[ship.length]--;
+        openHits -= ship.length;
+    }
+    if (openHits > 0) hits.forEach([&](int x, int y) { aimAround(x, y); });
+    else openHits = 0;
+    updateLattice();
+}
+
+void ParityStrategy::push(int x, int y) {
+    if (!Grid::inBounds(x, y) || hits.test(x, y) || stackSize == STACK_SIZE) return;
+    stack[stackSize++] = (uint8_t)(x * GRID_SIZE + y);
+}
+
+void ParityStrategy::aimAround(int x, int y) {
+    const int STEP_X[DIRECTION_COUNT] = {0, 1, 1};
+    const int STEP_Y[DIRECTION_COUNT] = {1, 0, 1};
+    for (int d = 0; d < DIRECTION_COUNT; ++d)
+    {
+        push(x + STEP_X[d], y + STEP_Y[d]);
+        push(x - STEP_X[d], y - STEP_Y[d]);
+    }
+
+    // A neighbouring hit on the same axis means the ship probably runs that way,
+    // so the open cells just past both ends of the run go on top
+    for (int d = 0; d < DIRECTION_COUNT; ++d)
+    {
+        int dx = STEP_X[d], dy = STEP_Y[d];
+        bool inLine = (Grid::inBounds(x + dx, y + dy) && hits.test(x + dx, y + dy))
+                   || (Grid::inBounds(x - dx, y - dy) && hits.test(x - dx, y - dy));
+        if (!inLine) continue;
+        int ax = x, ay = y, bx = x, by = y;
+        while (Grid::inBounds(ax + dx, ay + dy) && hits.test(ax + dx, ay + dy)) { ax += dx; ay += dy; }
+        while (Grid::inBounds(bx - dx, by - dy) && hits.test(bx - dx, by - dy)) { bx -= dx; by -= dy; }
+        push(ax + dx, ay + dy);
+        push(bx - dx, by - dy);
+    }
+}
+
+void ParityStrategy::updateLattice() {
+    int shortest = MAX_SHIP_LENGTH + 1;
+    for (int length = MAX_SHIP_LENGTH; length >= 1; --length)
+    {
+        if (floating[length] > 0) shortest = length;
+    }
+    Mask next = huntLattice(shortest > MAX_SHIP_LENGTH ? 1 : shortest, phase);
+    if (!(next == lattice)) cursor = 0;     // Cells skipped so far may be on the new lattice
+    lattice = next;
+}
+
+unique_ptr<Strategy> makeStrategy(const string& name, Rng& rng) {
+    if (name == "random") return unique_ptr<Strategy>(new RandomStrategy(rng));
+    if (name == "playout") return unique_ptr<Strategy>(new PlayoutStrategy(rng));
+    if (name == "density") return unique_ptr<Strategy>(new DensityStrategy(rng));
+    if (name == "parity") return unique_ptr<Strategy>(new ParityStrategy(rng));
+    if (name == "mcts") return unique_ptr<Strategy>(new MctsStrategy(rng));
+    if (name.compare(0, 5, "mcts:") == 0)
+    {
+        // "mcts:MS[:THREADS]" in milliseconds, or "mcts:Ni[:THREADS]" for N iterations per move
+        const char* text = name.c_str() + 5;
+        char* end = nullptr;
+        double budget = strtod(text, &end);
+        bool counted = *end == 'i';
+        if (end == text || !(budget > 0) || !isfinite(budget)) return nullptr;
+        if (counted && (budget != floor(budget) || budget > 1e15)) return nullptr;
+        if (counted) ++end;
+
+        long threads = 1;
+        if (*end == ':')
+        {
+            text = end + 1;
+            threads = strtol(text, &end, 10);
+            if (end == text || threads < 1 || threads > 1024) return nullptr;
+        }
+        if (*end != '\0') return nullptr;
+
+        unique_ptr<Strategy> strategy(new MctsStrategy(rng));
+        MctsPlanner& planner = static_cast<MctsStrategy&>(*strategy).planner;
+        if (counted) planner.iterations = (long long)budget;
+        else planner.budgetMilliseconds = budget;
+        planner.threads = (int)threads;
+        return strategy;
+    }
+    return nullptr;
+}
@@ -0,0 +1,108 @@
+#ifndef STRATEGY_HPP
+#define STRATEGY_HPP
+
+#include <memory>
+#include <string>
+#include "DensityMap.hpp"
+#include "Engine.hpp"
+#include "Rng.hpp"
+#include "Snapshot.hpp"
+
+using namespace std;
+
+class Player;
+
+// Picks moves for an automated player. Always plays for engine.attacker().
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+    virtual void reset() {}                                     // Called before every new game
+    virtual Action chooseAction(const GameEngine& engine) = 0;
+    virtual void observe(const GameEngine& engine, const Action& action, const Result& result) {} // After our own move
+};
+
+// Fires at a uniformly random cell it has not tried yet, never uses the power-up
+class RandomStrategy : public Strategy {
+public:
+    explicit RandomStrategy(Rng& rng) : rng(rng) {}
+    Action chooseAction(const GameEngine& engine) override;
+
+private:
+    Rng& rng;
+};
+
+// Random fire that also spends the captain's power-up at a random moment, aimed at
+// a random spot. Cheap enough to play thousands of games out to the end.
+class PlayoutStrategy : public Strategy {
+public:
+    explicit PlayoutStrategy(Rng& rng) : rng(rng), fire(rng) {}
+    Action chooseAction(const GameEngine& engine) override;
+
+private:
+    static const uint32_t POWER_UP_ODDS = 10;   // Chance per turn of 1 in this
+
+    Rng& rng;
+    RandomStrategy fire;
+};
+
+// Fires at the cell the most remaining placements of the opponent's fleet run
+// through, kept up to date shot by shot in a DensityMap. Never uses the power-up.
+// Follows the shared OpeningBook line, when there is one, until the first hit.
+class DensityStrategy : public Strategy {
+public:
+    explicit DensityStrategy(Rng& rng) : rng(rng), ready(false) {}
+    void reset() override { ready = false; }
+    Action chooseAction(const GameEngine& engine) override;
+    void observe(const GameEngine& engine, const Action& action, const Result& result) override { density.record(result); }
+
+private:
+    Rng& rng;
+    DensityMap density;
+    bool ready;     // Set up on the first move, once the opponent's fleet is known
+};
+
+// Cheap hunt/target baseline. Hunting walks a shuffled order of the cells that every
+// h, v or d run of the shortest ship still afloat must cross. A hit pushes its six
+// neighbours on a fixed stack, and two hits in a line push the cells at both ends
+// of the line on top, so the target follows the ship. No heap use per move.
+class ParityStrategy : public Strategy {
+public:
+    explicit ParityStrategy(Rng& rng) : rng(rng), ready(false) {}
+    void reset() override { ready = false; }
+    Action chooseAction(const GameEngine& engine) override;
+    void observe(const GameEngine& engine, const Action& action, const Result& result) override;
+
+    // Cells (x + y) % period in the kept residues, never missing a ship of 'shortest' or longer
+    static Mask huntLattice(int shortest, int phase);
+
+private:
+    static const int STACK_SIZE = 256;  // Six neighbours plus two line ends per hit, with room to spare
+
+    Rng& rng;
+    bool ready;
+    int phase;                          // Picked per game so the lattice cannot be played around
+    int fleet[MAX_SHIPS];               // Opponent ship lengths by id
+    int fleetSize;
+    int floating[MAX_SHIP_LENGTH + 1];  // Opponent ships of each length not sunk yet
+    int openHits;                       // Hits not yet accounted for by a sunk ship
+    Mask hits;
+    Mask lattice;
+    uint8_t stack[STACK_SIZE];
+    int stackSize;
+    uint8_t order[CELL_COUNT];          // Hunting order, shuffled once per game
+    int cursor;                         // Cells before it are explored or off the lattice
+
+    void start(const GameEngine& engine);
+    void push(int x, int y);
+    void aimAround(int x, int y);
+    void updateLattice();
+};
+
+// Cells the player has not shot at or revealed yet, islands excluded
+Mask unexploredCells(const Player& player);
+
+// Strategy by name ("random", "playout", "density", "parity", "mcts[:MS[:THREADS]]", "mcts:Ni[:THREADS]"),
+// null if the name is unknown or its budget or thread count is not a positive number
+unique_ptr<Strategy> makeStrategy(const string& name, Rng& rng);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TERRAIN_HPP
+#define TERRAIN_HPP
+
+#include <memory>
+#include "Board.hpp"
+#include "Rng.hpp"
+
+using namespace std;
+
+// The island layout of a map. It never changes once built, so both players
+// (and any number of simulated games on the same map) share one instance.
+class Terrain {
+public:
+    const Mask islands;
+
+    explicit Terrain(const Mask& islands) : islands(islands) {}
+
+    uint64_t hash() const { return hashOf(islands); }
+
+    // Same value for the same islands in every run, usable as a key on disk
+    static uint64_t hashOf(const Mask& islands) {
+        uint64_t h = 0;
+        for (int k = 0; k < Mask::WORDS; ++k)
+        {
+            uint64_t state = h ^ islands.w[k];
+            h = splitMix64(state);
+        }
+        return h;
+    }
+
+    static shared_ptr<const Terrain> openSeas() {
+        static const shared_ptr<const Terrain> empty = make_shared<const Terrain>(Mask());
+        return empty; // All water, one copy for the whole program
+    }
+
+    // Shattered Sea layout drawn from the game's generator
+    static Mask scatterIslands(Rng& rng) {
+        Mask islands = {};
+        int numIslands = rng.below(15) + 5;    // Between 5 and 19 islands
+        for (int i = 0; i < numIslands; ++i)
+        {
+            int x = rng.below(GRID_SIZE);      // Random row
+            int y = rng.below(GRID_SIZE);      // Random column
+            islands |= Mask::cell(x, y);       // Place island
+        }
+        return islands;
+    }
+};
+
+typedef shared_ptr<const Terrain> TerrainPtr;
+
+#endif
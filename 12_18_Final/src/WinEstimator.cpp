@@ -0,0 +1,246 @@
+#include "WinEstimator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include "Player.hpp"
+#include "Snapshot.hpp"
+#include "Strategy.hpp"
+
+// 95% Wilson score interval for p over n samples, stays inside [0, 1] even when one side is far ahead
+static void wilsonInterval(double p, long long n, double& low, double& high) {
+    const double Z = 1.96;
+    double denominator = 1 + Z * Z / n;
+    double center = (p + Z * Z / (2.0 * n)) / denominator;
+    double spread = Z * sqrt(p * (1 - p) / n + Z * Z / (4.0 * n * n)) / denominator;
+    low = max(0.0, center - spread);
+    high = min(1.0, center + spread);
+}
+
+WinEstimator::WinEstimator()
+    : targetHalfWidth(0.03), minSamples(200), maxSamples(200000), budgetMilliseconds(100),
+      threads((int)thread::hardware_concurrency()), maxTurns(1000) {}
+
+// Randomized depth-first search for a fleet that fits the opponent's view.
+// Each level makes the most constrained decision left: place a sunk ship
+// (entirely on hits) or cover a hit nobody covers yet, whichever has the
+// fewest options, and backs out at once when either has none. Once both are
+// settled the floating ships go anywhere. Options are tried in random order.
+class FleetSearch {
+public:
+    FleetSearch(const Player& owner, const Player& opponent, Rng& rng, vector<const Placement*>& fleet)
+        : owner(owner), opponent(opponent), rng(rng), fleet(fleet), hits(owner.grid.hits), budget(NODE_BUDGET),
+          options(owner.ships.size() + 1), picks(owner.ships.size() + 1) {}
+
+    bool run() {
+        fleet.assign(owner.ships.size(), nullptr);
+        if (owner.ships.size() > (size_t)MAX_SHIPS) return false;  // More than the per-ship tallies hold
+        // Power-up scans only mark water on the scanner's guess grid, so take the opponent's misses too
+        return place(owner.grid.misses | opponent.guessGrid.misses | owner.terrain->islands, 0);
+    }
+
+private:
+    static const int NODE_BUDGET = 2000;    // Give up on hopeless positions instead of stalling a playout
+
+    struct Choice {
+        const Placement* placement;
+        int id;
+    };
+
+    const Player& owner;
+    const Player& opponent;
+    Rng& rng;
+    vector<const Placement*>& fleet;
+    Mask hits;
+    int budget;
+    vector<vector<Choice>> options;         // Every fitting spot of every unplaced ship, one list per depth
+    vector<vector<Choice>> picks;           // The ones for the decision made at that depth
+
+    bool place(const Mask& used, int depth) {
+        if (--budget < 0) return false;
+        vector<Choice>& all = options[depth];
+        vector<Choice>& list = picks[depth];
+        all.clear();
+        list.clear();
+
+        // Options per ship, and how many of them cover each open hit. With no open
+        // hit and no sunk ship left, only the next ship's options matter.
+        Mask openHits = hits.andNot(used);
+        bool constrained = openHits.any();
+        for (int id = 0; id < (int)fleet.size(); ++id)
+        {
+            if (!fleet[id] && owner.ships[id].sunk()) constrained = true;
+        }
+        int shipOptions[MAX_SHIPS] = {};    // run() turns down bigger fleets
+        int hitOptions[CELL_COUNT] = {};
+        for (int id = 0; id < (int)fleet.size(); ++id)
+        {
+            if (fleet[id]) continue;
+            if (!constrained && !all.empty()) break;
+            const Ship& ship = owner.ships[id];
+            forEachLegalPlacement(used, ship.length, [&](const Placement& p) {
+                bool allHit = p.cells.andNot(hits).none();  // A sunk ship lies entirely on hits, a floating one does not
+                if (allHit != ship.sunk()) return;
+                all.push_back({&p, id});
+                shipOptions[id]++;
+                (p.cells & openHits).forEach([&](int x, int y) { hitOptions[x * GRID_SIZE + y]++; });
+            });
+        }
+
+        // Most constrained decision first, a dead end shows up as zero options
+        int bestShip = -1, bestHit = -1, fewest = 1 << 30;
+        for (int id = 0; id < (int)fleet.size(); ++id)
+        {
+            if (fleet[id] || !owner.ships[id].sunk()) continue;
+            if (shipOptions[id] < fewest)
+            {
+                fewest = shipOptions[id];
+                bestShip = id;
+            }
+        }
+        openHits.forEach([&](int x, int y) {
+            int cell = x * GRID_SIZE + y;
+            if (hitOptions[cell] < fewest)
+            {
+                fewest = hitOptions[cell];
+                bestHit = cell;
+                bestShip = -1;
+            }
+        });
+        if (fewest == 0) return false;
+
+        if (bestShip < 0 && bestHit < 0)
+        {
+            // Only floating ships are left and every hit is covered, take the first one
+            for (int id = 0; id < (int)fleet.size() && bestShip < 0; ++id)
+            {
+                if (!fleet[id]) bestShip = id;
+            }
+            if (bestShip < 0) return true; // Whole fleet placed
+        }
+
+        for (const Choice& choice : all)
+        {
+            bool wanted = bestHit >= 0 ? choice.placement->cells.test(bestHit / GRID_SIZE, bestHit % GRID_SIZE)
+                                       : choice.id == bestShip;
+            if (wanted) list.push_back(choice);
+        }
+
+        // Lazy shuffle: draw the next choice from the ones not tried yet
+        for (int left = (int)list.size(); left > 0; --left)
+        {
+            int pick = (int)rng.below((uint32_t)left);
+            Choice choice = list[pick];
+            list[pick] = list[left - 1];
+            list[left - 1] = choice;
+
+            fleet[choice.id] = choice.placement;
+            if (place(used | choice.placement->cells, depth + 1)) return true;
+            fleet[choice.id] = nullptr;
+            if (budget < 0) return false;
+        }
+        return false;
+    }
+};
+
+bool sampleHiddenFleet(const Player& owner, const Player& opponent, Rng& rng, vector<const Placement*>& fleet) {
+    return FleetSearch(owner, opponent, rng, fleet).run();
+}
+
+double WinEstimator::playOut(GameEngine& game, const GameSnapshot& start, Rng& rng) const {
+    // Back to the real position, then redraw what neither side can see
+    game.restore(start);
+    vector<const Placement*> fleet;
+    for (int side = 0; side < 2; ++side)
+    {
+        // The real layout is never played on, a failed draw throws the sample away
+        Player& player = *game.state.players[side];
+        if (!sampleHiddenFleet(player, *game.state.players[1 - side], rng, fleet)) return -1.0;
+        player.redeployFleet(fleet);
+    }
+
+    PlayoutStrategy policy(rng);
+    while (game.state.phase == Phase::Battle && game.state.turn < maxTurns)
+    {
+        Action action = policy.chooseAction(game);
+        if (!game.apply(action).accepted)
+        {
+            // Power-up turned down (e.g. Steven out of triple shots), fire instead,
+            // and pass if even that fails so a playout can never spin in place
+            if (!game.apply(RandomStrategy(rng).chooseAction(game)).accepted) game.apply(Action::endTurn());
+        }
+    }
+    if (game.state.winner < 0) return 0.5;
+    return game.state.winner == 0 ? 1.0 : 0.0;
+}
+
+WinEstimate WinEstimator::estimate(const GameEngine& engine, uint64_t seed) const {
+    WinEstimate result = {0.5, 0.0, 1.0, 0, 0.0};
+    auto start = chrono::steady_clock::now();
+    if (engine.state.phase == Phase::Finished)
+    {
+        result.probability = result.low = result.high = engine.state.winner == 0 ? 1.0 : 0.0;
+        return result;
+    }
+    if (engine.state.phase != Phase::Battle) return result; // Fleets not out yet, nothing to go on
+
+    // Wins are counted in half points so a draw can count as half. Samples sit in the
+    // low 32 bits and half wins above them, so one load always sees a matching pair.
+    const uint64_t ONE_SAMPLE = 1, HALF_WIN = 1ULL << 32;
+    long long limit = min(maxSamples, 1LL << 30);   // Keeps both halves from overflowing
+    atomic<uint64_t> totals(0);
+    auto samplesIn = [](uint64_t t) { return (long long)(t & 0xFFFFFFFFULL); };
+    auto halfWinsIn = [](uint64_t t) { return (long long)(t >> 32); };
+    atomic<bool> stop(false);
+    Rng master(seed);
+    GameSnapshot position = engine.snapshot();
+    vector<thread> workers;
+    int workerCount = threads < 1 ? 1 : threads;
+    for (int t = 0; t < workerCount; ++t)
+    {
+        Rng rng = master.split();   // Own stream per worker
+        workers.emplace_back([&, rng]() mutable {
+            // One private pair of players per worker, every playout restores into them
+            unique_ptr<Player> players[2] = {unique_ptr<Player>(engine.state.players[0]->clone()),
+                                             unique_ptr<Player>(engine.state.players[1]->clone())};
+            GameEngine game = engine;
+            game.state.players[0] = players[0].get();
+            game.state.players[1] = players[1].get();
+            while (!stop.load(memory_order_relaxed) && samplesIn(totals.load(memory_order_relaxed)) < limit)
+            {
+                double outcome = playOut(game, position, rng);
+                if (outcome < 0) continue;  // No fleet fit, draw again
+                totals += ONE_SAMPLE + HALF_WIN * (uint64_t)(2 * outcome);
+            }
+        });
+    }
+
+    // Poll the running totals and stop the workers once the interval is tight
+    for (;;)
+    {
+        this_thread::sleep_for(chrono::microseconds(500));
+        uint64_t now = totals.load();
+        long long n = samplesIn(now);
+        double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (n >= limit || elapsed >= budgetMilliseconds) break;
+        if (n < minSamples) continue;
+
+        double low, high;
+        wilsonInterval(halfWinsIn(now) / (2.0 * n), n, low, high);
+        if (high - low <= 2 * targetHalfWidth) break;
+    }
+    stop = true;
+    for (thread& worker : workers) worker.join();
+
+    uint64_t final = totals.load();
+    long long n = samplesIn(final);
+    result.samples = n;
+    result.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (n == 0) return result;
+
+    result.probability = halfWinsIn(final) / (2.0 * n);
+    wilsonInterval(result.probability, n, result.low, result.high);
+    return result;
+}
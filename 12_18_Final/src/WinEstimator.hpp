@@ -0,0 +1,47 @@
+#ifndef WINESTIMATOR_HPP
+#define WINESTIMATOR_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Engine.hpp"
+#include "Placement.hpp"
+#include "Rng.hpp"
+
+using namespace std;
+
+class Player;
+
+// Chance that player 1 (engine.state.players[0]) wins from here
+struct WinEstimate {
+    double probability;     // Player 2's chance is 1 - probability
+    double low, high;       // 95% Wilson interval around it
+    long long samples;      // Playouts it took
+    double milliseconds;
+};
+
+// Monte Carlo odds for a game in progress. Each sample redraws both hidden
+// fleets to fit what the opponent has seen (hits, misses, sunk ships, islands),
+// never falling back to the real ones, keeps the power-up state, and plays the
+// game out with PlayoutStrategy on both sides. Worker threads sample until the
+// interval is tight enough or the time budget runs out.
+class WinEstimator {
+public:
+    double targetHalfWidth;     // Stop once the interval is this narrow
+    long long minSamples;       // Never stop before this many playouts
+    long long maxSamples;
+    double budgetMilliseconds;  // Hard limit on wall time
+    int threads;
+    int maxTurns;               // Playouts past this count as a draw (half a win each)
+
+    WinEstimator();
+    WinEstimate estimate(const GameEngine& engine, uint64_t seed) const;
+
+private:
+    double playOut(GameEngine& game, const GameSnapshot& start, Rng& rng) const;  // 1, 0 or 0.5 for player 1, -1 if no fleet fit
+};
+
+// Draws a fleet for 'owner' consistent with what 'opponent' knows about it,
+// one placement per ship in fleet order. False if the search gave up without one.
+bool sampleHiddenFleet(const Player& owner, const Player& opponent, Rng& rng, vector<const Placement*>& fleet);
+
+#endif
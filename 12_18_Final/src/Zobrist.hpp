@@ -0,0 +1,49 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+#include "Board.hpp"
+#include "Rng.hpp"
+
+using namespace std;
+
+// Every (layer, cell) pair that can be set gets its own random key,
+// WATER is the empty state and has no key
+enum ZobristLayer {
+    OWN_SHIP,
+    OWN_HIT,
+    OWN_MISS,
+    GUESS_HIT,
+    GUESS_MISS,
+    ZOBRIST_LAYERS
+};
+
+struct ZobristTable {
+    uint64_t keys[ZOBRIST_LAYERS][CELL_COUNT];
+};
+
+constexpr ZobristTable buildZobristTable() {
+    ZobristTable table = {};
+    uint64_t state = 424;   // Fixed seed so hashes match across runs and machines
+    for (int layer = 0; layer < ZOBRIST_LAYERS; ++layer)
+    {
+        for (int i = 0; i < CELL_COUNT; ++i)
+        {
+            table.keys[layer][i] = splitMix64(state);
+        }
+    }
+    return table;
+}
+
+inline constexpr ZobristTable ZOBRIST = buildZobristTable();
+
+// XOR of the keys of every cell in 'cells' on one layer
+inline uint64_t zobristOf(const Mask& cells, int layer) {
+    uint64_t h = 0;
+    cells.forEach([&](int x, int y) {
+        h ^= ZOBRIST.keys[layer][x * GRID_SIZE + y];
+    });
+    return h;
+}
+
+#endif
@@ -1,7 +1,35 @@
+#include <cstdlib>
+#include <random>
+#include <string>
 #include "Game.hpp"
+#include "OpeningBook.hpp"
 
-int main() {
-    Game game;
+int main(int argc, char* argv[]) {
+    // Optional seed argument replays a logged game, otherwise start from a fresh one.
+    // --virtual-clock skips the handoff pauses and times blitz turns by input count (scripted runs),
+    // --odds shows the estimated win chances after every turn, --hints the best power-up target,
+    // --book PATH reads the computer's openings from another file than opening_book.bin.
+    uint64_t seed = ((uint64_t)random_device()() << 32) ^ random_device()();
+    bool virtualClock = false;
+    bool showOdds = false;
+    bool showHints = false;
+    string bookPath = "opening_book.bin";
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "--virtual-clock") virtualClock = true;
+        else if (arg == "--odds") showOdds = true;
+        else if (arg == "--hints") showHints = true;
+        else if (arg == "--book" && i + 1 < argc) bookPath = argv[++i];
+        else seed = strtoull(arg.c_str(), nullptr, 10);
+    }
+
+    OpeningBook::shared().open(bookPath);  // No book is fine, the computer thinks every move through
+
+    unique_ptr<Clock> clock(virtualClock ? (Clock*)new VirtualClock() : (Clock*)new RealClock());
+    Game game(seed, move(clock));
+    game.showOdds = showOdds;
+    game.showHints = showHints;
     game.start();
     return 0;
 }